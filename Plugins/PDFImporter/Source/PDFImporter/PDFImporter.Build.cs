@@ -31,10 +31,18 @@ public class PDFImporter : ModuleRules
 				"Slate",
 				"SlateCore",
                 "Projects",
+                "RenderCore",
+                "RHI",
 				// ... add private dependencies that you statically link with here ...	
 			}
 			);
 
+        // Rendered pages are shared through the derived data cache in the editor
+        if (Target.bBuildEditor)
+        {
+            PrivateDependencyModuleNames.Add("DerivedDataCache");
+        }
+
         string GhostscriptPath = Path.Combine(ModuleDirectory, "..", "..", "ThirdParty");
         string Platform = string.Empty;
 	
@@ -6,6 +6,7 @@ class FAsyncExecTask : public FNonAbandonableTask
 {
 private:
 	friend class FAutoDeleteAsyncTask<FAsyncExecTask>;
+	friend class FAsyncTask<FAsyncExecTask>;
 
 private:
 	TFunction<void()> Work;
@@ -1,17 +1,15 @@
 // Fill out your copyright notice in the Description page of Project Settings.
 
 #include "ConvertPdfToPdfAsset.h"
-#include "GhostscriptCore.h"
 #include "PDF.h"
-#include "AsyncExecTask.h"
+#include "PDFImporter.h"
 #include "Misc/Paths.h"
 
 UConvertPdfToPdfAsset::UConvertPdfToPdfAsset(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer), WorldContextObject(nullptr), bIsActive(false), 
-	  PDFFilePath(""), Dpi(0), FirstPage(0), LastPage(0)
+	  PDFFilePath(""), Dpi(0), FirstPage(0), LastPage(0), bRenderPagesOnDemand(false),
+	  Compression(EPDFPageCompression::Uncompressed), Priority(EPDFConversionPriority::Normal)
 {
-	FPDFImporterModule& PDFImporterModule = FModuleManager::LoadModuleChecked<FPDFImporterModule>(FName("PDFImporter"));
-	GhostscriptCore = PDFImporterModule.GetGhostscriptCore();
 }
 
 UConvertPdfToPdfAsset* UConvertPdfToPdfAsset::ConvertPdfToPdfAsset(
@@ -19,7 +17,10 @@ UConvertPdfToPdfAsset* UConvertPdfToPdfAsset::ConvertPdfToPdfAsset(
 	const FString& PDF_FilePath, 
 	int Dpi,
 	int FirstPage,
-	int LastPage
+	int LastPage,
+	bool bRenderPagesOnDemand,
+	EPDFPageCompression Compression,
+	EPDFConversionPriority Priority
 ){
 	UConvertPdfToPdfAsset* Node = NewObject<UConvertPdfToPdfAsset>();
 	Node->WorldContextObject = WorldContextObject;
@@ -27,6 +28,9 @@ UConvertPdfToPdfAsset* UConvertPdfToPdfAsset::ConvertPdfToPdfAsset(
 	Node->Dpi = Dpi;
 	Node->FirstPage = FirstPage;
 	Node->LastPage = LastPage;
+	Node->bRenderPagesOnDemand = bRenderPagesOnDemand;
+	Node->Compression = Compression;
+	Node->Priority = Priority;
 	return Node;
 }
 
@@ -44,19 +48,84 @@ void UConvertPdfToPdfAsset::Activate()
 		return;
 	}
 	
-	// ϊJn
-	auto ConvertTask = new FAutoDeleteAsyncTask<FAsyncExecTask>([this]() 
+	FPDFImporterModule& PDFImporterModule = FModuleManager::LoadModuleChecked<FPDFImporterModule>(FName("PDFImporter"));
+	TSharedPtr<FPDFConversionQueue, ESPMode::ThreadSafe> ConversionQueue = PDFImporterModule.GetConversionQueue();
+	if (!ConversionQueue.IsValid())
 	{
-		UPDF* PDFAsset = GhostscriptCore->ConvertPdfToPdfAsset(PDFFilePath, Dpi, FirstPage, LastPage);
-		if (PDFAsset != nullptr)
+		Failed.Broadcast();
+		return;
+	}
+
+	FPDFConversionOptions Options;
+	Options.InputPath = PDFFilePath;
+	Options.Dpi = Dpi;
+	Options.FirstPage = FirstPage;
+	Options.LastPage = LastPage;
+	Options.bRenderPagesOnDemand = bRenderPagesOnDemand;
+	Options.Compression = Compression;
+
+	// ϊI܂Ńm[hGCȂ悤ɂ
+	RegisterWithGameInstance(WorldContextObject);
+	bIsActive = true;
+
+	// ϊJn
+	// ʒm̓Q[Xbhōs邪Am[hɔjꂽꍇɔĎQƂŎ󂯎
+	TWeakObjectPtr<UConvertPdfToPdfAsset> WeakThis(this);
+	ConversionTask = ConversionQueue->StartConversion(Options, Priority,
+		FOnPDFConversionProgress::CreateLambda([WeakThis](int NumConvertedPages, int NumPages)
 		{
-			Completed.Broadcast(PDFAsset);
-		}
-		else
+			if (WeakThis.IsValid())
+			{
+				WeakThis->Progress.Broadcast(NumConvertedPages, NumPages);
+			}
+		}),
+		FOnPDFConversionFinished::CreateLambda([WeakThis](UPDF* PDFAsset)
 		{
-			Failed.Broadcast();
-		}
-	});
+			if (WeakThis.IsValid())
+			{
+				WeakThis->HandleConversionFinished(PDFAsset);
+			}
+		})
+	);
+}
+
+void UConvertPdfToPdfAsset::Cancel()
+{
+	if (ConversionTask.IsValid())
+	{
+		ConversionTask->Cancel();
+	}
+}
+
+void UConvertPdfToPdfAsset::BeginDestroy()
+{
+	// ʂ󂯎m[hȂȂ̂Ŏc̃y[W͕ϊȂ
+	if (ConversionTask.IsValid() && !ConversionTask->IsFinished())
+	{
+		ConversionTask->Cancel();
+	}
+
+	Super::BeginDestroy();
+}
+
+void UConvertPdfToPdfAsset::HandleConversionFinished(UPDF* PDFAsset)
+{
+	const bool bWasCancelled = ConversionTask.IsValid() && ConversionTask->IsCancelled();
+	ConversionTask.Reset();
+	bIsActive = false;
+
+	if (bWasCancelled)
+	{
+		Cancelled.Broadcast();
+	}
+	else if (PDFAsset != nullptr)
+	{
+		Completed.Broadcast(PDFAsset);
+	}
+	else
+	{
+		Failed.Broadcast();
+	}
 
-	ConvertTask->StartBackgroundTask();
+	SetReadyToDestroy();
 }
@@ -1,10 +1,27 @@
 #include "GhostscriptCore.h"
 #include "PDF.h"
+#include "PDFImporterSettings.h"
+#include "AsyncExecTask.h"
+#include "PageBitmapQueue.h"
+#include "PDFRenderCache.h"
+#include "PageTextureEncoder.h"
+#include "PageTextureUploader.h"
+#include "RenderSlotScheduler.h"
+#include "ThumbnailAtlasBuilder.h"
 #include "Engine/Texture2D.h"
+#include "ImageUtils.h"
+#include "RenderUtils.h"
+#include "RHI.h"
+#include "Runtime/Launch/Resources/Version.h"
 #include "Misc/Paths.h"
 #include "Misc/FileHelper.h"
 #include "GenericPlatform/GenericPlatformProcess.h"
 #include "HAL/FileManager.h"
+#include "Misc/QueuedThreadPool.h"
+#include "HAL/ThreadSafeCounter.h"
+#include "HAL/ThreadSafeBool.h"
+#include "Misc/Guid.h"
+#include "Misc/SecureHash.h"
 #include "AssetRegistryModule.h"
 #include "IImageWrapperModule.h"
 #include "IImageWrapper.h"
@@ -14,9 +31,160 @@
 #include <Windows.h>
 #include "HideWindowsPlatformTypes.h"
 
+// displayfoCX̏o͌` (gdevdsp.h)
+static const unsigned int DISPLAY_COLORS_RGB = (1 << 2);
+static const unsigned int DISPLAY_UNUSED_LAST = (1 << 7);
+static const unsigned int DISPLAY_DEPTH_8 = (1 << 11);
+static const unsigned int DISPLAY_LITTLEENDIAN = (1 << 16);
+static const unsigned int DISPLAY_TOPFIRST = (0 << 17);
+
+// 1fB,G,R,x̏ɕׂ`
+static const unsigned int DisplayFormatBGRA = DISPLAY_COLORS_RGB | DISPLAY_UNUSED_LAST | DISPLAY_DEPTH_8 | DISPLAY_LITTLEENDIAN | DISPLAY_TOPFIRST;
+
+// Rendering state shared with the display device callbacks
+struct FDisplayDeviceContext
+{
+	FDisplayDeviceContext(FPageBitmapCallback InOnPageRendered, int FirstPage)
+		: Image(nullptr), Width(0), Height(0), Raster(0), OnPageRendered(InOnPageRendered), PageNumber(FirstPage) {}
+
+	// Raster of the page being rendered, owned by Ghostscript
+	unsigned char* Image;
+	int Width;
+	int Height;
+	int Raster;
+
+	// Destination of the finished pages
+	FPageBitmapCallback OnPageRendered;
+	int PageNumber;
+};
+
+// display_callback of gdevdsp.h (version 2)
+struct FDisplayDeviceCallback
+{
+	int Size;
+	int VersionMajor;
+	int VersionMinor;
+	int(*Open)(void* Handle, void* Device);
+	int(*PreClose)(void* Handle, void* Device);
+	int(*Close)(void* Handle, void* Device);
+	int(*PreSize)(void* Handle, void* Device, int Width, int Height, int Raster, unsigned int Format);
+	int(*Size)(void* Handle, void* Device, int Width, int Height, int Raster, unsigned int Format, unsigned char* Image);
+	int(*Sync)(void* Handle, void* Device);
+	int(*Page)(void* Handle, void* Device, int Copies, int Flush);
+	int(*Update)(void* Handle, void* Device, int X, int Y, int Width, int Height);
+	void*(*MemAlloc)(void* Handle, void* Device, unsigned long Size);
+	int(*MemFree)(void* Handle, void* Device, void* Memory);
+	int(*Separation)(void* Handle, void* Device, int Component, const char* ComponentName, unsigned short C, unsigned short M, unsigned short Y, unsigned short K);
+};
+
+static int DisplayNoop(void* Handle, void* Device)
+{
+	return 0;
+}
+
+static int DisplayPreSize(void* Handle, void* Device, int Width, int Height, int Raster, unsigned int Format)
+{
+	return 0;
+}
+
+static int DisplaySize(void* Handle, void* Device, int Width, int Height, int Raster, unsigned int Format, unsigned char* Image)
+{
+	FDisplayDeviceContext* Context = static_cast<FDisplayDeviceContext*>(Handle);
+	Context->Image = Image;
+	Context->Width = Width;
+	Context->Height = Height;
+	Context->Raster = Raster;
+	return 0;
+}
+
+static int DisplayPage(void* Handle, void* Device, int Copies, int Flush)
+{
+	FDisplayDeviceContext* Context = static_cast<FDisplayDeviceContext*>(Handle);
+	if (Context->Image == nullptr)
+	{
+		return -1;
+	}
+
+	// sƂɃpfBÔ1sRs[
+	FPageBitmap Bitmap;
+	Bitmap.Width = Context->Width;
+	Bitmap.Height = Context->Height;
+	Bitmap.Pixels.SetNumUninitialized(Context->Width * Context->Height * 4);
+
+	const int RowSize = Context->Width * 4;
+	for (int Row = 0; Row < Context->Height; Row++)
+	{
+		FMemory::Memcpy(Bitmap.Pixels.GetData() + Row * RowSize, Context->Image + Row * Context->Raster, RowSize);
+	}
+
+	// displayfoCX̓At@܂Ȃ̂ŕsɂ
+	for (int Index = 3; Index < Bitmap.Pixels.Num(); Index += 4)
+	{
+		Bitmap.Pixels[Index] = 0xFF;
+	}
+
+	// Ăяoϊ~߂ꍇ̓G[ԂGhostscript𒆒f
+	return Context->OnPageRendered(Context->PageNumber++, Bitmap) ? 0 : -1;
+}
+
+static int DisplayUpdate(void* Handle, void* Device, int X, int Y, int Width, int Height)
+{
+	return 0;
+}
+
+static const FDisplayDeviceCallback DisplayDeviceCallback =
+{
+	sizeof(FDisplayDeviceCallback),
+	2,	// DISPLAY_VERSION_MAJOR
+	0,	// DISPLAY_VERSION_MINOR
+	DisplayNoop,	// display_open
+	DisplayNoop,	// display_preclose
+	DisplayNoop,	// display_close
+	DisplayPreSize,
+	DisplaySize,
+	DisplayNoop,	// display_sync
+	DisplayPage,
+	DisplayUpdate,
+	nullptr,		// display_memalloc : GhostscriptɔC
+	nullptr,		// display_memfree
+	nullptr			// display_separation
+};
+
+// A`GCAX̐ݒ (_[LbṼL[ɂg)
+static const int TextAlphaBits = 4;
+static const int GraphicsAlphaBits = 4;
+
+// gsapi_init_with_argsquitŏI̖߂l
+static const int GhostscriptErrorQuit = -101;
+
+static int GhostscriptStdIn(void* Handle, char* Buffer, int Length)
+{
+	return 0;
+}
+
+static int GhostscriptStdOut(void* Handle, const char* Text, int Length)
+{
+	FString* StandardOutput = static_cast<FString*>(Handle);
+	StandardOutput->Append(FString(Length, Text));
+	return Length;
+}
+
+static int GhostscriptStdErr(void* Handle, const char* Text, int Length)
+{
+	return Length;
+}
+
+// PostScript̕ƂĈ悤ɃGXP[v
+static FString EscapePathForPostScript(const FString& Path)
+{
+	FString EscapedPath = Path.Replace(TEXT("\\"), TEXT("/"));
+	return EscapedPath.Replace(TEXT("("), TEXT("\\(")).Replace(TEXT(")"), TEXT("\\)"));
+}
+
 const FString FGhostscriptCore::PagesDirectoryPath = FPaths::ConvertRelativePathToFull(FPaths::Combine(IPluginManager::Get().FindPlugin(TEXT("PDFImporter"))->GetBaseDir(), TEXT("Content")));
 
 FGhostscriptCore::FGhostscriptCore()
+	: RenderThreadPool(nullptr)
 {
 	// dllt@C̃pX擾
 	FString GhostscriptDllPath = FPaths::ConvertRelativePathToFull(FPaths::Combine(FPaths::ProjectPluginsDir(), TEXT("PDFImporter"), TEXT("ThirdParty")));
@@ -27,101 +195,847 @@ FGhostscriptCore::FGhostscriptCore()
 #endif
 	GhostscriptDllPath = FPaths::Combine(GhostscriptDllPath, TEXT("gsdll.dll"));
 
-	// W[[h
-	GhostscriptModule = FPlatformProcess::GetDllHandle(*GhostscriptDllPath);
-	if (GhostscriptModule == nullptr)
+	// W[[h
+	GhostscriptModule = FPlatformProcess::GetDllHandle(*GhostscriptDllPath);
+	if (GhostscriptModule == nullptr)
+	{
+		UE_LOG(PDFImporter, Fatal, TEXT("Failed to load Ghostscript module"));
+	}
+
+	// ֐|C^擾
+	CreateInstance = (CreateAPIInstance)FPlatformProcess::GetDllExport(GhostscriptModule, TEXT("gsapi_new_instance"));
+	DeleteInstance = (DeleteAPIInstance)FPlatformProcess::GetDllExport(GhostscriptModule, TEXT("gsapi_delete_instance"));
+	Init = (InitAPI)FPlatformProcess::GetDllExport(GhostscriptModule, TEXT("gsapi_init_with_args"));
+	Exit = (ExitAPI)FPlatformProcess::GetDllExport(GhostscriptModule, TEXT("gsapi_exit"));
+	if (CreateInstance == nullptr || DeleteInstance == nullptr || Init == nullptr || Exit == nullptr)
+	{
+		UE_LOG(PDFImporter, Fatal, TEXT("Failed to get Ghostscript function pointer"));
+	}
+
+	// displayfoCXɑΉĂȂꍇjpegoRĕϊ
+	SetDisplayCallback = (SetDisplayCallbackAPI)FPlatformProcess::GetDllExport(GhostscriptModule, TEXT("gsapi_set_display_callback"));
+	if (SetDisplayCallback == nullptr)
+	{
+		UE_LOG(PDFImporter, Warning, TEXT("Ghostscript display device is not available, pages will be converted via jpeg"));
+	}
+
+	// y[W̎擾Ɏgp
+	SetStdio = (SetStdioAPI)FPlatformProcess::GetDllExport(GhostscriptModule, TEXT("gsapi_set_stdio"));
+
+	// ɓGhostscript̃CX^X͑SĂ̕ϊŋL
+	RenderSlots = MakeShareable(new FRenderSlotScheduler(GetDefault<UPDFImporterSettings>()->GetNumRenderWorkers()));
+
+	RenderCache = MakeShareable(new FPDFRenderCache(FPaths::ConvertRelativePathToFull(FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("PDFImporter"), TEXT("RenderCache")))));
+
+	IImageWrapperModule& ImageWrapperModule = FModuleManager::LoadModuleChecked<IImageWrapperModule>(FName("ImageWrapper"));
+	ImageWrapper = ImageWrapperModule.CreateImageWrapper(EImageFormat::JPEG);
+
+	UE_LOG(PDFImporter, Log, TEXT("Ghostscrip dll loaded"));
+}
+
+FGhostscriptCore::~FGhostscriptCore()
+{
+	if (RenderThreadPool != nullptr)
+	{
+		RenderThreadPool->Destroy();
+		delete RenderThreadPool;
+	}
+
+	FPlatformProcess::FreeDllHandle(GhostscriptModule);
+	UE_LOG(PDFImporter, Log, TEXT("Ghostscript dll unloaded"));
+}
+
+UPDF* FGhostscriptCore::ConvertPdfToPdfAsset(const FString& InputPath, int Dpi, int FirstPage, int LastPage, bool bIsImportIntoEditor, EPDFPageCompression Compression, bool bUseVirtualTextures, const FConversionProgressCallback& OnProgress)
+{
+	IFileManager& FileManager = IFileManager::Get();
+	
+	// PDF邩mF
+	if (!FileManager.FileExists(*InputPath))
+	{
+		UE_LOG(PDFImporter, Error, TEXT("File not found : %s"), *InputPath);
+		return nullptr;
+	}
+
+	// zeNX`̓GfB^ō쐬eNX`AZbgłgȂ
+	const bool bVirtualTexture = bIsImportIntoEditor && bUseVirtualTextures && CanUseVirtualTextures();
+	if (bUseVirtualTextures && !bVirtualTexture)
+	{
+		UE_LOG(PDFImporter, Warning, TEXT("Virtual textures are not available, pages are imported as regular textures : %s"), *InputPath);
+	}
+
+	// i񍐂邽߂ɐɃy[W𒲂ׂĂ
+	int NumPages = 0;
+	if (OnProgress)
+	{
+		if (FirstPage > 0 && LastPage > 0 && FirstPage <= LastPage)
+		{
+			NumPages = LastPage - FirstPage + 1;
+		}
+		else
+		{
+			NumPages = GetPageCount(InputPath);
+			if (NumPages > 0)
+			{
+				FirstPage = 1;
+				LastPage = NumPages;
+			}
+		}
+
+		if (!OnProgress(0, NumPages))
+		{
+			return nullptr;
+		}
+	}
+
+	// sɃ[J[Xbhŕϊꍇ̓sNZf[^̍쐬܂łsAeNX`̓Q[Xbhŏ쐬
+	TSharedPtr<FPageTextureUploader> TextureUploader;
+	TSharedPtr<FPageTextureUploadBatch, ESPMode::ThreadSafe> UploadBatch;
+	if (!bIsImportIntoEditor && !IsInGameThread())
+	{
+		FPDFImporterModule* PDFImporterModule = FModuleManager::GetModulePtr<FPDFImporterModule>(FName("PDFImporter"));
+		TextureUploader = PDFImporterModule != nullptr ? PDFImporterModule->GetTextureUploader() : nullptr;
+		if (TextureUploader.IsValid())
+		{
+			UploadBatch = TextureUploader->CreateBatch();
+		}
+	}
+
+	// ϊIy[W珇ԂɃeNX`쐬
+	TArray<UTexture2D*> Buffer;
+	int NumEncodedPages = 0;
+	TArray<FString> PageHashes;
+	const FString Filename = FPaths::GetBaseFilename(InputPath);
+	const double StartTime = FPlatformTime::Seconds();
+	double TextureSeconds = 0.0;
+	bool bIsConverted = ConvertPdfToBitmaps(InputPath, Dpi, FirstPage, LastPage, [&](int PageNumber, FPageBitmap& Bitmap)
+	{
+		const double TextureStartTime = FPlatformTime::Seconds();
+
+		// zeNX`łȂ΍쐬łő̑傫Ɏ߂
+		if (!bVirtualTexture)
+		{
+			FitBitmapToMaxTextureSize(Bitmap);
+		}
+
+		if (UploadBatch.IsValid())
+		{
+			TSharedRef<FPageTextureData, ESPMode::ThreadSafe> TextureData = MakeShared<FPageTextureData, ESPMode::ThreadSafe>();
+			FPageTextureEncoder::Encode(Bitmap, Compression, *TextureData);
+			TextureUploader->Enqueue(UploadBatch.ToSharedRef(), NumEncodedPages++, TextureData);
+			TextureSeconds += FPlatformTime::Seconds() - TextureStartTime;
+			return !OnProgress || OnProgress(NumEncodedPages, NumPages);
+		}
+
+		UTexture2D* TextureTemp;
+		if (CreatePageTexture(Bitmap, Buffer.Num(), Filename, bIsImportIntoEditor, Compression, bVirtualTexture, TextureTemp))
+		{
+			Buffer.Add(TextureTemp);
+
+			// ăC|[gɕύXꂽy[W邽
+			if (bIsImportIntoEditor)
+			{
+				PageHashes.Add(GetPageBitmapHash(Bitmap));
+			}
+		}
+		TextureSeconds += FPlatformTime::Seconds() - TextureStartTime;
+
+		// LZꂽꍇ͕ϊ𒆒f
+		return !OnProgress || OnProgress(Buffer.Num(), NumPages);
+	});
+
+	// Ō̃y[W̌ɃLZꂽꍇTlC̍쐬ƕۑs킸ɒf
+	if (bIsConverted && OnProgress && !OnProgress(UploadBatch.IsValid() ? NumEncodedPages : Buffer.Num(), NumPages))
+	{
+		bIsConverted = false;
+	}
+
+	// Q[Xbhō쐬ꂽeNX`PDFAZbgQƂ܂ŃAbv[_[ێ
+	// LZꂽꍇ͎c̃y[W̃eNX`҂ɉAPDFAZbgȂ
+	if (UploadBatch.IsValid())
+	{
+		if (bIsConverted)
+		{
+			const double WaitStartTime = FPlatformTime::Seconds();
+			TextureUploader->WaitForBatch(UploadBatch.ToSharedRef(), Buffer);
+			TextureSeconds += FPlatformTime::Seconds() - WaitStartTime;
+		}
+		else
+		{
+			TextureUploader->ReleaseBatch(UploadBatch.ToSharedRef());
+		}
+	}
+	const double ConvertSeconds = FPlatformTime::Seconds() - StartTime;
+
+	if (!bIsConverted)
+	{
+#if WITH_EDITORONLY_DATA
+		// fꍇ͍쐬ς݂̃eNX`AZbgcȂ
+		if (bIsImportIntoEditor)
+		{
+			FinishTextureAssets(Buffer, Compression, bVirtualTexture);
+			DiscardTextureAssets(Buffer);
+		}
+#endif
+		return nullptr;
+	}
+
+	// y[W̃eNX`͐y[WƂ̃pbP[Wɂ܂Ƃ߂Ă̂ōŌɈxۑ
+	double SaveSeconds = 0.0;
+	double WriteSeconds = 0.0;
+	double ThumbnailSeconds = 0.0;
+	TArray<UTexture2D*> ThumbnailAtlases;
+	TArray<FPDFPageThumbnail> PageThumbnails;
+#if WITH_EDITORONLY_DATA
+	if (bIsImportIntoEditor && Buffer.Num() > 0)
+	{
+		// keNX`̍쐬̓[J[XbhőĂ̂Ŋ҂
+		const double FinishStartTime = FPlatformTime::Seconds();
+		FinishTextureAssets(Buffer, Compression, bVirtualTexture);
+		TextureSeconds += FPlatformTime::Seconds() - FinishStartTime;
+
+		// TlC̃AgXPDFAZbgɓǂݍ܂̂Ńy[WƂ͕ʂ̃pbP[Wɍ쐬Ĉꏏɕۑ
+		const double ThumbnailStartTime = FPlatformTime::Seconds();
+		if (!BuildThumbnailAtlases(InputPath, FirstPage, LastPage, Filename, ThumbnailAtlases, PageThumbnails) || (PageThumbnails.Num() > 0 && PageThumbnails.Num() != Buffer.Num()))
+		{
+			UE_LOG(PDFImporter, Warning, TEXT("Failed to create the page thumbnails : %s"), *InputPath);
+			DiscardTextureAssets(ThumbnailAtlases);
+			ThumbnailAtlases.Reset();
+			PageThumbnails.Reset();
+		}
+		ThumbnailSeconds = FPlatformTime::Seconds() - ThumbnailStartTime;
+
+		const double SaveStartTime = FPlatformTime::Seconds();
+		TArray<UTexture2D*> TexturesToSave = Buffer;
+		TexturesToSave.Append(ThumbnailAtlases);
+		if (!SaveTextureAssetPackages(TexturesToSave, &WriteSeconds))
+		{
+			// ۑĂȂpbP[WQƂPDFAZbg͍Ȃ
+			UE_LOG(PDFImporter, Error, TEXT("Failed to save the page textures : %s"), *Buffer[0]->GetOutermost()->GetName());
+			DiscardTextureAssets(ThumbnailAtlases);
+			DiscardTextureAssets(Buffer);
+			return nullptr;
+		}
+		SaveSeconds = FPlatformTime::Seconds() - SaveStartTime - WriteSeconds;
+	}
+#endif
+
+	UE_LOG(PDFImporter, Log, TEXT("Converted %s : %d pages, waiting for pages %.2fs, creating textures %.2fs, creating thumbnails %.2fs, saving packages %.2fs, waiting for package writes %.2fs"),
+		*InputPath, Buffer.Num(), ConvertSeconds - TextureSeconds, TextureSeconds, ThumbnailSeconds, SaveSeconds, WriteSeconds);
+
+	// PDFAZbg쐬
+	UPDF* PDFAsset = NewObject<UPDF>();
+
+	if (FirstPage <= 0 || LastPage <= 0 || FirstPage > LastPage)
+	{
+		FirstPage = 1;
+		LastPage = Buffer.Num();
+	}
+
+	PDFAsset->PageRange = FPageRange(FirstPage, LastPage);
+	PDFAsset->Dpi = Dpi;
+	PDFAsset->Compression = Compression;
+	PDFAsset->bVirtualTexturePages = bVirtualTexture;
+	PDFAsset->Pages = Buffer;
+	PDFAsset->PageHashes = PageHashes;
+	PDFAsset->ThumbnailAtlases = ThumbnailAtlases;
+	PDFAsset->PageThumbnails = PageThumbnails;
+
+	if (UploadBatch.IsValid())
+	{
+		TextureUploader->ReleaseBatch(UploadBatch.ToSharedRef());
+	}
+
+	return PDFAsset;
+}
+
+#if WITH_EDITORONLY_DATA
+bool FGhostscriptCore::ReimportPdfAsset(UPDF* PDFAsset, const FString& InputPath, int Dpi, int FirstPage, int LastPage, TArray<UTexture2D*>& OutRemovedPages)
+{
+	if (PDFAsset == nullptr || !IFileManager::Get().FileExists(*InputPath))
+	{
+		return false;
+	}
+
+	// ύX̂Ȃy[W̃eNX`p̂őSēǂݍł
+	PDFAsset->LoadAllPages();
+
+	// eNX`AZbg͌PDF̖ÕpbP[Wɍ쐬Ă
+	const FString Filename = FPaths::GetBaseFilename(PDFAsset->Filename);
+	TArray<UTexture2D*> NewPages;
+	TArray<FString> NewPageHashes;
+	int NumCreatedPages = 0;
+
+	// eςy[W͐VeNX`ɏ݁ASĐĂÂeNX`Ɠւ
+	// rŎsĂÂeNX`PageHashes͂̂܂܎c
+	TArray<UTexture2D*> StagedPages;
+	TArray<UTexture2D*> ReplacedPages;
+
+	// zeNX`̃y[W̓LoXUMGŕ`łȂ̂ŁAełSĒʏ̃eNX`ɍ蒼
+	const bool bReplaceAllPages = PDFAsset->bVirtualTexturePages;
+
+	// eNX`쐬łȂy[WΎc̃y[WϊɑŜsɂ
+	bool bHasTextureFailed = false;
+	bool bIsConverted = ConvertPdfToBitmaps(InputPath, Dpi, FirstPage, LastPage, [&](int PageNumber, FPageBitmap& Bitmap)
+	{
+		FitBitmapToMaxTextureSize(Bitmap);
+
+		const int PageIndex = NewPages.Num();
+		const FString PageHash = GetPageBitmapHash(Bitmap);
+		UTexture2D* OldTexture = PDFAsset->Pages.IsValidIndex(PageIndex) ? PDFAsset->Pages[PageIndex] : nullptr;
+
+		if (OldTexture != nullptr && !bReplaceAllPages && PDFAsset->PageHashes.IsValidIndex(PageIndex) && PDFAsset->PageHashes[PageIndex] == PageHash)
+		{
+			NewPages.Add(OldTexture);
+		}
+		else
+		{
+			// ςy[WƑy[W͓pbP[WɐV쐬
+			UTexture2D* NewTexture;
+			if (!CreateTextureAssetFromBitmap(Bitmap, Filename, PDFAsset->Compression, false, NewTexture, GetPagePackageIndex(PageIndex)))
+			{
+				UE_LOG(PDFImporter, Error, TEXT("Failed to create the texture of page %d : %s"), PageNumber, *InputPath);
+				bHasTextureFailed = true;
+				return false;
+			}
+			NewPages.Add(NewTexture);
+			StagedPages.Add(NewTexture);
+
+			if (OldTexture != nullptr)
+			{
+				ReplacedPages.Add(OldTexture);
+			}
+			else
+			{
+				NumCreatedPages++;
+			}
+		}
+
+		NewPageHashes.Add(PageHash);
+		return true;
+	});
+
+	FinishTextureAssets(StagedPages, PDFAsset->Compression, false);
+
+	// r܂łNewPagesœւƎc̃y[W폜̂ŁAPDFAZbgɂ͉fȂ
+	if (!bIsConverted || bHasTextureFailed || NewPages.Num() == 0)
+	{
+		DiscardTextureAssets(StagedPages);
+		return false;
+	}
+
+	// y[WςꍇƃTlCȂÂAZbg̓TlCVAgXɍ蒼
+	// AgXy[WƓpbP[WɂÂAZbg蒼ăAgXp̃pbP[WɈڂ
+	// 쐬Ɏsꍇ̓C|[gƓTlCȂɂ
+	TArray<UTexture2D*> ThumbnailAtlases = PDFAsset->ThumbnailAtlases;
+	TArray<FPDFPageThumbnail> PageThumbnails = PDFAsset->PageThumbnails;
+	TArray<UTexture2D*> NewAtlases;
+	const FString ThumbnailPackageName = GetTexturePackageName(Filename, ThumbnailPackageIndex);
+	const bool bRebuildThumbnails = StagedPages.Num() > 0 || NewPages.Num() != PDFAsset->Pages.Num()
+		|| (GetDefault<UPDFImporterSettings>()->ThumbnailDpi > 0 && PageThumbnails.Num() != NewPages.Num())
+		|| ThumbnailAtlases.ContainsByPredicate([&ThumbnailPackageName](UTexture2D* Atlas) { return Atlas != nullptr && Atlas->GetOutermost()->GetName() != ThumbnailPackageName; });
+	if (bRebuildThumbnails)
+	{
+		if (!BuildThumbnailAtlases(InputPath, FirstPage, LastPage, Filename, NewAtlases, PageThumbnails) || (PageThumbnails.Num() > 0 && PageThumbnails.Num() != NewPages.Num()))
+		{
+			UE_LOG(PDFImporter, Warning, TEXT("Failed to create the page thumbnails : %s"), *InputPath);
+			DiscardTextureAssets(NewAtlases);
+			NewAtlases.Reset();
+			PageThumbnails.Reset();
+		}
+		ThumbnailAtlases = NewAtlases;
+	}
+
+	// ύXꂽy[Wƍ蒼AgX̃pbP[Wۑ
+	TArray<UTexture2D*> TexturesToSave = StagedPages;
+	TexturesToSave.Append(NewAtlases);
+	if (TexturesToSave.Num() > 0 && !SaveTextureAssetPackages(TexturesToSave))
+	{
+		DiscardTextureAssets(NewAtlases);
+		DiscardTextureAssets(StagedPages);
+		return false;
+	}
+
+	// ւÂeNX`ƌy[W̃eNX`A蒼ÕAgX͌Ăяoō폜
+	const int NumRemovedPages = FMath::Max(PDFAsset->Pages.Num() - NewPages.Num(), 0);
+	OutRemovedPages.Append(ReplacedPages);
+	if (bRebuildThumbnails)
+	{
+		for (UTexture2D* OldAtlas : PDFAsset->ThumbnailAtlases)
+		{
+			if (OldAtlas != nullptr)
+			{
+				OutRemovedPages.Add(OldAtlas);
+			}
+		}
+	}
+	for (int PageIndex = NewPages.Num(); PageIndex < PDFAsset->Pages.Num(); PageIndex++)
+	{
+		if (PDFAsset->Pages[PageIndex] != nullptr)
+		{
+			OutRemovedPages.Add(PDFAsset->Pages[PageIndex]);
+		}
+	}
+
+	UE_LOG(PDFImporter, Log, TEXT("Reimported %s : %d pages changed, %d pages added, %d pages removed, %d pages unchanged"),
+		*InputPath, ReplacedPages.Num(), NumCreatedPages, NumRemovedPages, NewPages.Num() - StagedPages.Num());
+
+	if (FirstPage <= 0 || LastPage <= 0 || FirstPage > LastPage)
+	{
+		FirstPage = 1;
+		LastPage = NewPages.Num();
+	}
+
+	PDFAsset->PageRange = FPageRange(FirstPage, LastPage);
+	PDFAsset->Dpi = Dpi;
+	PDFAsset->bVirtualTexturePages = false;
+	PDFAsset->Pages = NewPages;
+	PDFAsset->PageHashes = NewPageHashes;
+	PDFAsset->UpdatePageAssets();
+	PDFAsset->ThumbnailAtlases = ThumbnailAtlases;
+	PDFAsset->PageThumbnails = PageThumbnails;
+
+	return true;
+}
+#endif
+
+UPDF* FGhostscriptCore::OpenPdfAsset(const FString& InputPath, int Dpi, int FirstPage, int LastPage, EPDFPageCompression Compression)
+{
+	// PDF邩mF
+	if (!IFileManager::Get().FileExists(*InputPath))
+	{
+		UE_LOG(PDFImporter, Error, TEXT("File not found : %s"), *InputPath);
+		return nullptr;
+	}
+
+	// y[WȂꍇ͑SẴy[Wϊ
+	const int PageCount = GetPageCount(InputPath);
+	if (PageCount <= 0)
+	{
+		return ConvertPdfToPdfAsset(InputPath, Dpi, FirstPage, LastPage, false, Compression);
+	}
+
+	if (!(FirstPage > 0 && LastPage > 0 && FirstPage <= LastPage))
+	{
+		FirstPage = 1;
+		LastPage = PageCount;
+	}
+	FirstPage = FMath::Min(FirstPage, PageCount);
+	LastPage = FMath::Min(LastPage, PageCount);
+
+	// eNX`̓y[Wvꂽɍ쐬
+	UPDF* PDFAsset = NewObject<UPDF>();
+	PDFAsset->PageRange = FPageRange(FirstPage, LastPage);
+	PDFAsset->Dpi = Dpi;
+	PDFAsset->Compression = Compression;
+	PDFAsset->Filename = InputPath;
+	PDFAsset->Pages.SetNumZeroed(LastPage - FirstPage + 1);
+	PDFAsset->bRenderPagesOnDemand = true;
+
+	return PDFAsset;
+}
+
+int FGhostscriptCore::GetPageCount(const FString& InputPath)
+{
+	// ϊƂPDFGhostscriptNȂ
+	FString ContentHash;
+	if (GetDefault<UPDFImporterSettings>()->bUseRenderCache)
+	{
+		ContentHash = RenderCache->GetContentHash(InputPath);
+		const int CachedPageCount = ContentHash.IsEmpty() ? 0 : RenderCache->LoadPageCount(ContentHash);
+		if (CachedPageCount > 0)
+		{
+			return CachedPageCount;
+		}
+	}
+
+	TArray<FString> Arguments =
+	{
+		TEXT("-q"),
+		TEXT("-dQUIET"),
+
+		TEXT("-dNODISPLAY"),	// `͂Ȃ
+		TEXT("-dSAFER"),		// MłȂPDF̂ŃZ[t[hŎsA
+		TEXT("--permit-file-read=") + InputPath,	// PostScriptJPDFǂݍ݂
+		TEXT("-dBATCH"),
+		TEXT("-dNOPAUSE"),
+		TEXT("-dNOPROMPT"),
+
+		// y[WWo͂ɏo
+		TEXT("-c"),
+		FString::Printf(TEXT("(%s) (r) file runpdfbegin pdfpagecount = quit"), *EscapePathForPostScript(InputPath))
+	};
+
+	FString StandardOutput;
+	FScopedRenderSlot RenderSlot(*RenderSlots);
+	if (!ExecuteGhostscript(Arguments, nullptr, &StandardOutput))
+	{
+		UE_LOG(PDFImporter, Warning, TEXT("Failed to get the number of pages : %s"), *InputPath);
+		return 0;
+	}
+
+	const int PageCount = FCString::Atoi(*StandardOutput.TrimStartAndEnd());
+	if (PageCount > 0 && !ContentHash.IsEmpty())
+	{
+		RenderCache->StorePageCount(ContentHash, PageCount);
+	}
+
+	return PageCount;
+}
+
+bool FGhostscriptCore::GetPageSize(const FString& InputPath, int PageNumber, FVector2D& OutSize)
+{
+	TArray<FString> Arguments =
+	{
+		TEXT("-q"),
+		TEXT("-dQUIET"),
+
+		TEXT("-dNODISPLAY"),	// `͂Ȃ
+		TEXT("-dSAFER"),		// MłȂPDF̂ŃZ[t[hŎsA
+		TEXT("--permit-file-read=") + InputPath,	// PostScriptJPDFǂݍ݂
+		TEXT("-dBATCH"),
+		TEXT("-dNOPAUSE"),
+		TEXT("-dNOPROMPT"),
+
+		// MediaBoxƉ]Wo͂ɏo
+		TEXT("-c"),
+		FString::Printf(TEXT("(%s) (r) file runpdfbegin %d pdfgetpage dup /MediaBox pget pop == /Rotate pget not { 0 } if = quit"),
+			*EscapePathForPostScript(InputPath), PageNumber)
+	};
+
+	FString StandardOutput;
+	FScopedRenderSlot RenderSlot(*RenderSlots);
+	if (!ExecuteGhostscript(Arguments, nullptr, &StandardOutput))
+	{
+		UE_LOG(PDFImporter, Warning, TEXT("Failed to get the size of page %d : %s"), PageNumber, *InputPath);
+		return false;
+	}
+
+	// [  E ] ] ̌`
+	TArray<FString> Values;
+	StandardOutput.Replace(TEXT("["), TEXT(" ")).Replace(TEXT("]"), TEXT(" ")).ParseIntoArrayWS(Values);
+	if (Values.Num() < 5)
+	{
+		UE_LOG(PDFImporter, Warning, TEXT("Failed to get the size of page %d : %s"), PageNumber, *InputPath);
+		return false;
+	}
+
+	OutSize.X = FMath::Abs(FCString::Atof(*Values[2]) - FCString::Atof(*Values[0]));
+	OutSize.Y = FMath::Abs(FCString::Atof(*Values[3]) - FCString::Atof(*Values[1]));
+
+	// ɉ]ꂽy[W͕ƍւ
+	const int Rotate = ((FCString::Atoi(*Values[4]) % 360) + 360) % 360;
+	if (Rotate == 90 || Rotate == 270)
+	{
+		Swap(OutSize.X, OutSize.Y);
+	}
+
+	return OutSize.X > 0.0f && OutSize.Y > 0.0f;
+}
+
+bool FGhostscriptCore::RenderPageRegion(const FString& InputPath, int PageNumber, int Dpi, const FVector2D& PageSize, const FIntRect& Region, FPageBitmap& OutBitmap)
+{
+	// ؂蔲displayfoCXłsȂ
+	if (SetDisplayCallback == nullptr || Region.Width() <= 0 || Region.Height() <= 0)
+	{
+		return false;
+	}
+
+	bool bIsRendered = false;
+	auto OnRegionRendered = [&](int RenderedPageNumber, FPageBitmap& Bitmap)
+	{
+		OutBitmap = MoveTemp(Bitmap);
+		bIsRendered = true;
+		return true;
+	};
+	FDisplayDeviceContext Context(OnRegionRendered, PageNumber);
+
+	// ̑傫̈̑傫ɌŒ肵APDF̌_͍Ȃ̂ŗ̈̍̍ɗ悤ɂ炷
+	const float PointsPerPixel = 72.0f / Dpi;
+	const float OffsetX = -Region.Min.X * PointsPerPixel;
+	const float OffsetY = Region.Max.Y * PointsPerPixel - PageSize.Y;
+
+	TArray<FString> Arguments = MakeRenderingArguments(Dpi, PageNumber, PageNumber);
+	Arguments.RemoveAll([](const FString& Argument) { return Argument.StartsWith(TEXT("-sPAPERSIZE=")); });
+	Arguments.Add(FString::Printf(TEXT("-g%dx%d"), Region.Width(), Region.Height()));
+	Arguments.Add(TEXT("-dFIXEDMEDIA"));	// PDF̃y[W̑傫Ŏ̑傫ςȂ
+	Arguments.Add(TEXT("-sDEVICE=display"));
+	Arguments.Add(FString::Printf(TEXT("-dDisplayFormat=%u"), DisplayFormatBGRA));
+	Arguments.Add(FString::Printf(TEXT("-sDisplayHandle=16#%llx"), (uint64)(UPTRINT)&Context));
+	Arguments.Add(TEXT("-c"));
+	Arguments.Add(FString::Printf(TEXT("<< /PageOffset [%f %f] >> setpagedevice"), OffsetX, OffsetY));
+	Arguments.Add(TEXT("-f"));
+	Arguments.Add(InputPath);
+
+	FScopedRenderSlot RenderSlot(*RenderSlots);
+	return ExecuteGhostscript(Arguments, &Context) && bIsRendered;
+}
+
+void FGhostscriptCore::StartRenderTask(TFunction<void()> Task)
+{
+	(new FAutoDeleteAsyncTask<FAsyncExecTask>(MoveTemp(Task)))->StartBackgroundTask(GetRenderThreadPool());
+}
+
+bool FGhostscriptCore::ConvertPdfToBitmaps(const FString& InputPath, int Dpi, int FirstPage, int LastPage, FPageBitmapCallback OnPageConverted)
+{
+	const FString CacheKey = GetRenderCacheKey(InputPath, Dpi);
+
+	// y[W͈͂w肳ĂȂꍇ͑Sy[Wϊ
+	if (!(FirstPage > 0 && LastPage > 0 && FirstPage <= LastPage))
+	{
+		FirstPage = 1;
+		LastPage = GetPageCount(InputPath);
+
+		// y[WȂꍇ͕łȂ̂1̃CX^XōŌ܂ŕϊ
+		if (LastPage <= 0)
+		{
+			return RenderPageRange(InputPath, Dpi, FirstPage, 0, CacheKey, OnPageConverted);
+		}
+	}
+
+	if (CacheKey.IsEmpty())
+	{
+		return RenderPageRange(InputPath, Dpi, FirstPage, LastPage, CacheKey, OnPageConverted);
+	}
+
+	int Page = FirstPage;
+	while (Page <= LastPage)
+	{
+		// LbVɂy[WGhostscriptg킸ɓn
+		FPageBitmap Bitmap;
+		if (RenderCache->LoadPage(CacheKey, Page, Bitmap))
+		{
+			if (!OnPageConverted(Page, Bitmap))
+			{
+				return false;
+			}
+			Page++;
+			continue;
+		}
+
+		// LbVɂȂAy[W܂Ƃ߂ĕϊ
+		int RangeLastPage = Page;
+		while (RangeLastPage < LastPage && !RenderCache->HasPage(CacheKey, RangeLastPage + 1))
+		{
+			RangeLastPage++;
+		}
+
+		// ĂяorŎ~߂ꍇsԂ̂ŁA͈̔͂̃LbVnGhostscriptN肵Ȃ
+		if (!RenderPageRange(InputPath, Dpi, Page, RangeLastPage, CacheKey, OnPageConverted))
+		{
+			return false;
+		}
+		Page = RangeLastPage + 1;
+	}
+
+	return true;
+}
+
+bool FGhostscriptCore::RenderPageRange(const FString& InputPath, int Dpi, int FirstPage, int LastPage, const FString& CacheKey, FPageBitmapCallback OnPageConverted)
+{
+	int NumWorkers = GetDefault<UPDFImporterSettings>()->GetNumRenderWorkers();
+	if (LastPage > 0)
+	{
+		NumWorkers = FMath::Clamp(NumWorkers, 1, LastPage - FirstPage + 1);
+	}
+	else
+	{
+		NumWorkers = 1;
+	}
+
+	int NextPage = FirstPage;
+	bool bIsStopped = false;
+	while (!RunRenderPipeline(InputPath, Dpi, NextPage, LastPage, NumWorkers, CacheKey, OnPageConverted, NextPage, bIsStopped))
+	{
+		// Ăяo~߂ꍇ͕ϊɎsƂĕԂ
+		if (bIsStopped || NumWorkers == 1)
+		{
+			return false;
+		}
+
+		// ɃCX^X쐬łȂdll̏ꍇȂǂ͎c̃y[W1̃CX^Xŕϊ
+		UE_LOG(PDFImporter, Warning, TEXT("Parallel rendering failed, rendering the remaining pages from page %d serially"), NextPage);
+		NumWorkers = 1;
+	}
+
+	return true;
+}
+
+FString FGhostscriptCore::GetRenderCacheKey(const FString& InputPath, int Dpi)
+{
+	if (!GetDefault<UPDFImporterSettings>()->bUseRenderCache)
+	{
+		return FString();
+	}
+
+	const FString ContentHash = RenderCache->GetContentHash(InputPath);
+	if (ContentHash.IsEmpty())
+	{
+		return FString();
+	}
+
+	// `挋ʂςݒL[Ɋ܂߂
+	const FString RenderOptions = FString::Printf(TEXT("%d-%d-%d"), Dpi, TextAlphaBits, GraphicsAlphaBits);
+	return FPDFRenderCache::MakeDocumentKey(ContentHash, RenderOptions);
+}
+
+bool FGhostscriptCore::RunRenderPipeline(const FString& InputPath, int Dpi, int FirstPage, int LastPage, int NumWorkers, const FString& CacheKey, FPageBitmapCallback OnPageConverted, int& OutNextPage, bool& bOutIsStopped)
+{
+	// ҋ@ły[W𐧌ăy[WɊ֌WȂ̎gpʂɕۂ
+	const int MaxPendingPages = GetDefault<UPDFImporterSettings>()->MaxPendingPages;
+	FPageBitmapQueue Queue(FirstPage, MaxPendingPages);
+
+	// [J[̓y[Wɏȃ`Noĕϊ
+	// 1̃CX^XŕϊꍇGhostscriptNȂ悤ɑSẴy[W1̃`Nɂ
+	const int PagesPerChunk = (NumWorkers == 1 || LastPage <= 0) ? MAX_int32 : FMath::Max(MaxPendingPages / NumWorkers, 1);
+
+	FThreadSafeCounter NextChunkIndex;
+	FThreadSafeCounter NumActiveWorkers(NumWorkers);
+	FThreadSafeBool bHasWorkerFailed(false);
+
+	TArray<TUniquePtr<FAsyncTask<FAsyncExecTask>>> Tasks;
+	for (int WorkerIndex = 0; WorkerIndex < NumWorkers; WorkerIndex++)
+	{
+		Tasks.Add(MakeUnique<FAsyncTask<FAsyncExecTask>>([&, this]()
+		{
+			while (true)
+			{
+				// fꂽɊJn[J[GhostscriptNȂ
+				if (Queue.IsAborted())
+				{
+					break;
+				}
+
+				// ̕ϊƃ`NƂɌŋ󂫂g
+				// `N͋󂫂𓾂ĂoAÕ`N󂫂҂܂܌̃`Nl܂Ȃ悤ɂ
+				FScopedRenderSlot RenderSlot(*RenderSlots);
+
+				const int64 ChunkFirstPage = FirstPage + (int64)NextChunkIndex.Increment() * PagesPerChunk - PagesPerChunk;
+				if (LastPage > 0 && ChunkFirstPage > LastPage)
+				{
+					break;
+				}
+
+				const int ChunkLastPage = LastPage > 0 ? (int)FMath::Min<int64>(ChunkFirstPage + PagesPerChunk - 1, LastPage) : 0;
+				bool bIsRendered = RenderPages(InputPath, Dpi, (int)ChunkFirstPage, ChunkLastPage, [&, this](int PageNumber, FPageBitmap& Bitmap)
+				{
+					// Ghostscriptg킸ɍςނ悤Ƀ[J[̃Xbhŏł
+					if (!CacheKey.IsEmpty())
+					{
+						RenderCache->StorePage(CacheKey, PageNumber, Bitmap);
+					}
+					return Queue.Push(PageNumber, Bitmap);
+				});
+
+				if (!bIsRendered)
+				{
+					// fꂽꍇ͎sƂĈȂ
+					if (!Queue.IsAborted())
+					{
+						bHasWorkerFailed = true;
+						Queue.Abort();
+					}
+					break;
+				}
+
+				if (LastPage <= 0)
+				{
+					break;
+				}
+			}
+
+			if (NumActiveWorkers.Decrement() == 0)
+			{
+				Queue.Close();
+			}
+		}));
+		Tasks.Last()->StartBackgroundTask(GetRenderThreadPool());
+	}
+
+	// ĂяõXbhŕϊIy[WԂɎ󂯎
+	int PageNumber;
+	FPageBitmap Bitmap;
+	bOutIsStopped = false;
+	while (Queue.Pop(PageNumber, Bitmap))
 	{
-		UE_LOG(PDFImporter, Fatal, TEXT("Failed to load Ghostscript module"));
+		if (!OnPageConverted(PageNumber, Bitmap))
+		{
+			bOutIsStopped = true;
+			break;
+		}
 	}
 
-	// ֐|C^擾
-	CreateInstance = (CreateAPIInstance)FPlatformProcess::GetDllExport(GhostscriptModule, TEXT("gsapi_new_instance"));
-	DeleteInstance = (DeleteAPIInstance)FPlatformProcess::GetDllExport(GhostscriptModule, TEXT("gsapi_delete_instance"));
-	Init = (InitAPI)FPlatformProcess::GetDllExport(GhostscriptModule, TEXT("gsapi_init_with_args"));
-	Exit = (ExitAPI)FPlatformProcess::GetDllExport(GhostscriptModule, TEXT("gsapi_exit"));
-	if (CreateInstance == nullptr || DeleteInstance == nullptr || Init == nullptr || Exit == nullptr)
+	OutNextPage = Queue.GetNextPage();
+	Queue.Abort();
+
+	for (TUniquePtr<FAsyncTask<FAsyncExecTask>>& Task : Tasks)
 	{
-		UE_LOG(PDFImporter, Fatal, TEXT("Failed to get Ghostscript function pointer"));
+		Task->EnsureCompletion();
 	}
 
-	IImageWrapperModule& ImageWrapperModule = FModuleManager::LoadModuleChecked<IImageWrapperModule>(FName("ImageWrapper"));
-	ImageWrapper = ImageWrapperModule.CreateImageWrapper(EImageFormat::JPEG);
+	return !bOutIsStopped && !bHasWorkerFailed;
+}
 
-	UE_LOG(PDFImporter, Log, TEXT("Ghostscrip dll loaded"));
+bool FGhostscriptCore::RenderPages(const FString& InputPath, int Dpi, int FirstPage, int LastPage, FPageBitmapCallback OnPageRendered)
+{
+	if (SetDisplayCallback != nullptr)
+	{
+		return RenderPagesWithDisplay(InputPath, Dpi, FirstPage, LastPage, OnPageRendered);
+	}
+
+	return RenderPagesViaJpeg(InputPath, Dpi, FirstPage, LastPage, OnPageRendered);
 }
 
-FGhostscriptCore::~FGhostscriptCore()
+bool FGhostscriptCore::RenderPagesWithDisplay(const FString& InputPath, int Dpi, int FirstPage, int LastPage, FPageBitmapCallback OnPageRendered)
 {
-	FPlatformProcess::FreeDllHandle(GhostscriptModule);
-	UE_LOG(PDFImporter, Log, TEXT("Ghostscript dll unloaded"));
+	FDisplayDeviceContext Context(OnPageRendered, FMath::Max(FirstPage, 1));
+
+	TArray<FString> Arguments = MakeRenderingArguments(Dpi, FirstPage, LastPage);
+	Arguments.Add(TEXT("-sDEVICE=display"));	// ɏo
+	Arguments.Add(FString::Printf(TEXT("-dDisplayFormat=%u"), DisplayFormatBGRA));
+	Arguments.Add(FString::Printf(TEXT("-sDisplayHandle=16#%llx"), (uint64)(UPTRINT)&Context));
+	Arguments.Add(InputPath);
+
+	return ExecuteGhostscript(Arguments, &Context);
 }
 
-UPDF* FGhostscriptCore::ConvertPdfToPdfAsset(const FString& InputPath, int Dpi, int FirstPage, int LastPage, bool bIsImportIntoEditor)
+bool FGhostscriptCore::RenderPagesViaJpeg(const FString& InputPath, int Dpi, int FirstPage, int LastPage, FPageBitmapCallback OnPageRendered)
 {
 	IFileManager& FileManager = IFileManager::Get();
-	
-	// PDF邩mF
-	if (!FileManager.FileExists(*InputPath))
-	{
-		UE_LOG(PDFImporter, Error, TEXT("File not found : %s"), *InputPath);
-		return nullptr;
-	}
 
 	// Ɨp̃fBNg쐬
-	FString TempDirPath = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("ConvertTemp"));
+	// ̃[J[ɎĝŃ[J[Ƃɕʂ̃fBNgɂ
+	FString TempDirPath = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("ConvertTemp"), FGuid::NewGuid().ToString());
 	TempDirPath = FPaths::ConvertRelativePathToFull(TempDirPath);
-	if (FileManager.DirectoryExists(*TempDirPath))
-	{
-		FileManager.DeleteDirectory(*TempDirPath);
-	}
-	FileManager.MakeDirectory(*TempDirPath);
+	FileManager.MakeDirectory(*TempDirPath, true);
 	UE_LOG(PDFImporter, Log, TEXT("A working directory has been created (%s)"), *TempDirPath);
 
+	bool bIsConverted = false;
+
 	// GhostscriptpPDFjpg摜쐬
 	FString OutputPath = FPaths::Combine(TempDirPath, FPaths::GetBaseFilename(InputPath) + TEXT("%010d.jpg"));
-	TArray<UTexture2D*> Buffer; 
-	UPDF* PDFAsset = nullptr;
-
 	if (ConvertPdfToJpeg(InputPath, OutputPath, Dpi, FirstPage, LastPage))
 	{
 		// 摜̃t@CpX擾
 		TArray<FString> PageNames;
-		IFileManager::Get().FindFiles(PageNames, *TempDirPath, L"jpg");
-		
+		FileManager.FindFiles(PageNames, *TempDirPath, TEXT("jpg"));
+		PageNames.Sort();
+
 		// 쐬jpg摜ǂݍ
-		UTexture2D* TextureTemp;
+		bIsConverted = true;
+		int PageNumber = FMath::Max(FirstPage, 1);
 		for (const FString& PageName : PageNames)
 		{
-			bool bResult = false;
-			if (bIsImportIntoEditor)
-			{
-#if WITH_EDITORONLY_DATA
-				bResult = CreateTextureAssetFromFile(FPaths::Combine(TempDirPath, PageName), TextureTemp);
-#endif
-			}
-			else
+			FPageBitmap Bitmap;
+			if (LoadBitmapFromFile(FPaths::Combine(TempDirPath, PageName), Bitmap))
 			{
-				bResult = LoadTexture2DFromFile(FPaths::Combine(TempDirPath, PageName), TextureTemp);
+				if (!OnPageRendered(PageNumber, Bitmap))
+				{
+					bIsConverted = false;
+					break;
+				}
 			}
-			
-			if (bResult)
-			{
-				Buffer.Add(TextureTemp);
-			}
-		}
-
-		// PDFAZbg쐬
-		PDFAsset = NewObject<UPDF>();
-
-		if (FirstPage <= 0 || LastPage <= 0 || FirstPage > LastPage)
-		{
-			FirstPage = 1;
-			LastPage = Buffer.Num();
+			PageNumber++;
 		}
-
-		PDFAsset->PageRange = FPageRange(FirstPage, LastPage);
-		PDFAsset->Dpi = Dpi;
-		PDFAsset->Pages = Buffer;
 	}
 
 	// ƃfBNg폜
@@ -131,61 +1045,101 @@ UPDF* FGhostscriptCore::ConvertPdfToPdfAsset(const FString& InputPath, int Dpi,
 		UE_LOG(PDFImporter, Log, TEXT("Successfully deleted working directory (%s)"), *TempDirPath);
 	}
 
-	return PDFAsset;
+	return bIsConverted;
 }
 
 bool FGhostscriptCore::ConvertPdfToJpeg(const FString& InputPath, const FString& OutputPath, int Dpi, int FirstPage, int LastPage)
 {
-	if (!(FirstPage > 0 && LastPage > 0 && FirstPage <= LastPage))
+	TArray<FString> Arguments = MakeRenderingArguments(Dpi, FirstPage, LastPage);
+	Arguments.Add(TEXT("-sDEVICE=jpeg"));	// jpeg`ŏo
+	Arguments.Add(TEXT("-sOutputFile=") + OutputPath);
+	Arguments.Add(InputPath);
+
+	return ExecuteGhostscript(Arguments);
+}
+
+TArray<FString> FGhostscriptCore::MakeRenderingArguments(int Dpi, int FirstPage, int LastPage) const
+{
+	if (FirstPage > 0 && LastPage <= 0)
+	{
+		// Ĩy[WȂꍇ͍Ō܂
+		LastPage = INT_MAX;
+	}
+	else if (!(FirstPage > 0 && LastPage > 0 && FirstPage <= LastPage))
 	{
 		FirstPage = 1;
 		LastPage = INT_MAX;
 	}
 
-	TArray<char> FirstPageBuffer = FStringToCharPtr(FString(TEXT("-dFirstPage=") + FString::FromInt(FirstPage)));
-	TArray<char> LastPageBuffer = FStringToCharPtr(FString(TEXT("-dLastPage=") + FString::FromInt(LastPage)));
-	TArray<char> DpiXBuffer = FStringToCharPtr(FString(TEXT("-dDEVICEXRESOLUTION=") + FString::FromInt(Dpi)));
-	TArray<char> DpiYBuffer = FStringToCharPtr(FString(TEXT("-dDEVICEYRESOLUTION=") + FString::FromInt(Dpi)));
-	TArray<char> OutputPathBuffer = FStringToCharPtr(FString(TEXT("-sOutputFile=") + OutputPath));
-	TArray<char> InputPathBuffer = FStringToCharPtr(InputPath);
-
-	const char* Args[20] =
+	TArray<FString> Arguments =
 	{
 		// GhostscriptWo͂ɏo͂Ȃ悤
-		"-q",
-		"-dQUIET",
+		TEXT("-q"),
+		TEXT("-dQUIET"),
 
-		"-dPARANOIDSAFER",			// Z[t[hŎs
-		"-dBATCH",					// GhostscriptC^NeBu[hɂȂȂ悤
-		"-dNOPAUSE",				// y[WƂ̈ꎞ~Ȃ悤
-		"-dNOPROMPT",				// R}hvvgłȂ悤           
-		"-dMaxBitmap=500000000",	// ptH[}Xコ
-		"-dNumRenderingThreads=4",	// }`RAŎs
+		TEXT("-dPARANOIDSAFER"),			// Z[t[hŎs
+		TEXT("-dBATCH"),					// GhostscriptC^NeBu[hɂȂȂ悤
+		TEXT("-dNOPAUSE"),					// y[WƂ̈ꎞ~Ȃ悤
+		TEXT("-dNOPROMPT"),					// R}hvvgłȂ悤
+		TEXT("-dMaxBitmap=500000000"),		// ptH[}Xコ
+		TEXT("-dNumRenderingThreads=4"),	// }`RAŎs
 
 		// o͉摜̃A`GCAX𑜓xȂ
-		"-dAlignToPixels=0",
-		"-dGridFitTT=0",
-		"-dTextAlphaBits=4",
-		"-dGraphicsAlphaBits=4",
-
-		"-sDEVICE=jpeg",	// jpeg`ŏo
-		"-sPAPERSIZE=a7",	// ̃TCY
-
-		FirstPageBuffer.GetData(),	// 14 : n߂̃y[Ww
-		LastPageBuffer.GetData(),	// 15 : Ĩy[Ww
-		DpiXBuffer.GetData(),		// 16 : DPI
-		DpiYBuffer.GetData(),		// 17 : cDPI
-		OutputPathBuffer.GetData(), // 18 : o̓pX
-		InputPathBuffer.GetData()	// 19 : ̓pX
+		TEXT("-dAlignToPixels=0"),
+		TEXT("-dGridFitTT=0"),
+		FString::Printf(TEXT("-dTextAlphaBits=%d"), TextAlphaBits),
+		FString::Printf(TEXT("-dGraphicsAlphaBits=%d"), GraphicsAlphaBits),
+
+		TEXT("-sPAPERSIZE=a7"),	// ̃TCY
 	};
 
+	Arguments.Add(TEXT("-dFirstPage=") + FString::FromInt(FirstPage));			// n߂̃y[Ww
+	Arguments.Add(TEXT("-dLastPage=") + FString::FromInt(LastPage));			// Ĩy[Ww
+	Arguments.Add(TEXT("-dDEVICEXRESOLUTION=") + FString::FromInt(Dpi));		// DPI
+	Arguments.Add(TEXT("-dDEVICEYRESOLUTION=") + FString::FromInt(Dpi));		// cDPI
+
+	return Arguments;
+}
+
+bool FGhostscriptCore::ExecuteGhostscript(const TArray<FString>& Arguments, void* DisplayContext, FString* StandardOutput)
+{
+	// ĂяõnhdisplayfoCXƕWo͂̂ǂ炩ɂgȂ
+	check(DisplayContext == nullptr || StandardOutput == nullptr);
+	if (StandardOutput != nullptr && SetStdio == nullptr)
+	{
+		return false;
+	}
+
+	// Ghostscriptɓn`ɕϊ
+	TArray<TArray<char>> ArgumentBuffers;
+	for (const FString& Argument : Arguments)
+	{
+		ArgumentBuffers.Add(FStringToCharPtr(Argument));
+	}
+
+	TArray<char*> Args;
+	for (TArray<char>& ArgumentBuffer : ArgumentBuffers)
+	{
+		Args.Add(ArgumentBuffer.GetData());
+	}
+
 	// Ghostscript̃CX^X쐬
 	void* GhostscriptInstance = nullptr;
-	CreateInstance(&GhostscriptInstance, 0);
+	CreateInstance(&GhostscriptInstance, DisplayContext != nullptr ? DisplayContext : StandardOutput);
 	if (GhostscriptInstance != nullptr)
 	{
+		if (DisplayContext != nullptr)
+		{
+			SetDisplayCallback(GhostscriptInstance, (void*)&DisplayDeviceCallback);
+		}
+
+		if (StandardOutput != nullptr)
+		{
+			SetStdio(GhostscriptInstance, GhostscriptStdIn, GhostscriptStdOut, GhostscriptStdErr);
+		}
+
 		// Ghostscripts
-		int Result = Init(GhostscriptInstance, 20, (char**)Args);
+		int Result = Init(GhostscriptInstance, Args.Num(), Args.GetData());
 
 		// GhostscriptI
 		Exit(GhostscriptInstance);
@@ -193,7 +1147,8 @@ bool FGhostscriptCore::ConvertPdfToJpeg(const FString& InputPath, const FString&
 
 		UE_LOG(PDFImporter, Log, TEXT("Ghostscript Return Code : %d"), Result);
 
-		return Result == 0;
+		// quitŏIꍇ
+		return Result == 0 || Result == GhostscriptErrorQuit;
 	}
 	else
 	{
@@ -202,7 +1157,22 @@ bool FGhostscriptCore::ConvertPdfToJpeg(const FString& InputPath, const FString&
 	}
 }
 
-bool FGhostscriptCore::LoadTexture2DFromFile(const FString& FilePath, class UTexture2D*& LoadedTexture)
+FQueuedThreadPool* FGhostscriptCore::GetRenderThreadPool()
+{
+	FScopeLock Lock(&RenderThreadPoolCriticalSection);
+
+	if (RenderThreadPool == nullptr)
+	{
+		// Ghostscript̓X^bN𑽂ĝő傫߂Ɋm
+		// ɓCX^XRenderSlotsŐ̂ŁA̕ϊ̃[J[󂫂҂Ă悤ɃXbh͑߂ɍ
+		RenderThreadPool = FQueuedThreadPool::Allocate();
+		RenderThreadPool->Create(GetDefault<UPDFImporterSettings>()->GetNumRenderWorkers() * 2, 2 * 1024 * 1024);
+	}
+
+	return RenderThreadPool;
+}
+
+bool FGhostscriptCore::LoadBitmapFromFile(const FString& FilePath, FPageBitmap& OutBitmap)
 {
 	// 摜f[^ǂݍ
 	TArray<uint8> RawFileData;
@@ -215,95 +1185,394 @@ bool FGhostscriptCore::LoadTexture2DFromFile(const FString& FilePath, class UTex
 		const TArray<uint8>* UncompressedRawData = nullptr;
 		if (ImageWrapper->GetRaw(ERGBFormat::BGRA, 8, UncompressedRawData))
 		{
-			// Texture2D쐬
-			UTexture2D* NewTexture = UTexture2D::CreateTransient(ImageWrapper->GetWidth(), ImageWrapper->GetHeight(), PF_B8G8R8A8);
-			if (!NewTexture)
-			{
-				return false;
-			}
+			OutBitmap.Width = ImageWrapper->GetWidth();
+			OutBitmap.Height = ImageWrapper->GetHeight();
+			OutBitmap.Pixels = *UncompressedRawData;
+			return true;
+		}
+	}
 
-			// sNZf[^eNX`ɏ
-			void* TextureData = NewTexture->PlatformData->Mips[0].BulkData.Lock(LOCK_READ_WRITE);
-			FMemory::Memcpy(TextureData, UncompressedRawData->GetData(), UncompressedRawData->Num());
-			NewTexture->PlatformData->Mips[0].BulkData.Unlock();
-			NewTexture->UpdateResource();
+	return false;
+}
 
-			LoadedTexture = NewTexture;
+bool FGhostscriptCore::CreatePageTexture(const FPageBitmap& Bitmap, int PageIndex, const FString& Filename, bool bIsImportIntoEditor, EPDFPageCompression Compression, bool bVirtualTexture, UTexture2D*& LoadedTexture)
+{
+	if (bIsImportIntoEditor)
+	{
+#if WITH_EDITORONLY_DATA
+		return CreateTextureAssetFromBitmap(Bitmap, Filename, Compression, bVirtualTexture, LoadedTexture, GetPagePackageIndex(PageIndex));
+#else
+		return false;
+#endif
+	}
 
-			return true;
+	return LoadTexture2DFromBitmap(Bitmap, LoadedTexture, Compression);
+}
+
+bool FGhostscriptCore::LoadTexture2DFromBitmap(const FPageBitmap& Bitmap, class UTexture2D*& LoadedTexture, EPDFPageCompression Compression)
+{
+	// kꍇ̓~bv}bv쐬Ă
+	if (Compression != EPDFPageCompression::Uncompressed)
+	{
+		FPageTextureData TextureData;
+		FPageTextureEncoder::Encode(Bitmap, Compression, TextureData);
+		return LoadTexture2DFromTextureData(TextureData, LoadedTexture);
+	}
+
+	// Texture2D쐬
+	UTexture2D* NewTexture = UTexture2D::CreateTransient(Bitmap.Width, Bitmap.Height, PF_B8G8R8A8);
+	if (!NewTexture)
+	{
+		return false;
+	}
+
+	// sNZf[^eNX`ɏ
+	void* TextureData = NewTexture->PlatformData->Mips[0].BulkData.Lock(LOCK_READ_WRITE);
+	FMemory::Memcpy(TextureData, Bitmap.Pixels.GetData(), Bitmap.Pixels.Num());
+	NewTexture->PlatformData->Mips[0].BulkData.Unlock();
+	NewTexture->UpdateResource();
+
+	LoadedTexture = NewTexture;
+
+	return true;
+}
+
+bool FGhostscriptCore::LoadTexture2DFromTextureData(const FPageTextureData& TextureData, UTexture2D*& LoadedTexture)
+{
+	UTexture2D* NewTexture = UTexture2D::CreateTransient(TextureData.Width, TextureData.Height, TextureData.Format);
+	if (!NewTexture || TextureData.Mips.Num() == 0)
+	{
+		return false;
+	}
+
+	// CreateTransient͍ŏʂ̃~bvȂ̂Ŏcǉ
+	FTexturePlatformData* PlatformData = NewTexture->PlatformData;
+	for (int MipIndex = 0; MipIndex < TextureData.Mips.Num(); MipIndex++)
+	{
+		FTexture2DMipMap* Mip;
+		if (MipIndex < PlatformData->Mips.Num())
+		{
+			Mip = &PlatformData->Mips[MipIndex];
+		}
+		else
+		{
+			Mip = new FTexture2DMipMap();
+			PlatformData->Mips.Add(Mip);
+			Mip->SizeX = FMath::Max(TextureData.Width >> MipIndex, 1);
+			Mip->SizeY = FMath::Max(TextureData.Height >> MipIndex, 1);
 		}
+
+		const TArray<uint8>& MipData = TextureData.Mips[MipIndex];
+		Mip->BulkData.Lock(LOCK_READ_WRITE);
+		void* Data = Mip->BulkData.Realloc(MipData.Num());
+		FMemory::Memcpy(Data, MipData.GetData(), MipData.Num());
+		Mip->BulkData.Unlock();
 	}
-	
-	return false;
+	NewTexture->UpdateResource();
+
+	LoadedTexture = NewTexture;
+
+	return true;
+}
+
+void FGhostscriptCore::FitBitmapToMaxTextureSize(FPageBitmap& Bitmap)
+{
+	const int MaxSize = (int)GetMax2DTextureDimension();
+	if (Bitmap.Width <= MaxSize && Bitmap.Height <= MaxSize)
+	{
+		return;
+	}
+
+	// cۂ܂ܒӂő̑傫ɍ킹
+	const float Scale = (float)MaxSize / FMath::Max(Bitmap.Width, Bitmap.Height);
+	const int Width = FMath::Clamp(FMath::FloorToInt(Bitmap.Width * Scale), 1, MaxSize);
+	const int Height = FMath::Clamp(FMath::FloorToInt(Bitmap.Height * Scale), 1, MaxSize);
+
+	UE_LOG(PDFImporter, Warning, TEXT("Page of %dx%d exceeds the maximum texture size and is shrunk to %dx%d, import it as virtual textures to keep the resolution"),
+		Bitmap.Width, Bitmap.Height, Width, Height);
+
+	ResizeBitmap(Bitmap, Width, Height);
+}
+
+void FGhostscriptCore::ResizeBitmap(FPageBitmap& Bitmap, int Width, int Height)
+{
+	// BGRA8FColorƓ
+	TArray<FColor> SourceColors;
+	SourceColors.SetNumUninitialized(Bitmap.Width * Bitmap.Height);
+	FMemory::Memcpy(SourceColors.GetData(), Bitmap.Pixels.GetData(), Bitmap.Pixels.Num());
+
+	TArray<FColor> ResizedColors;
+	FImageUtils::ImageResize(Bitmap.Width, Bitmap.Height, SourceColors, Width, Height, ResizedColors, false);
+
+	Bitmap.Width = Width;
+	Bitmap.Height = Height;
+	Bitmap.Pixels.SetNumUninitialized(Width * Height * 4);
+	FMemory::Memcpy(Bitmap.Pixels.GetData(), ResizedColors.GetData(), Bitmap.Pixels.Num());
 }
 
 #if WITH_EDITORONLY_DATA
-bool FGhostscriptCore::CreateTextureAssetFromFile(const FString& FilePath, class UTexture2D*& LoadedTexture)
+bool FGhostscriptCore::CreateTextureAssetFromBitmap(const FPageBitmap& Bitmap, const FString& Filename, EPDFPageCompression Compression, bool bVirtualTexture, class UTexture2D*& LoadedTexture, int PackageIndex, const FString& AssetName)
 {
-	// 摜f[^ǂݍ
-	TArray<uint8> RawFileData;
-	if (FFileHelper::LoadFileToArray(RawFileData, *FilePath))
+	// pbP[W쐬
+	FString AbsolutePackagePath = PagesDirectoryPath + TEXT("/") + Filename + TEXT("/");
+	FPackageName::RegisterMountPoint(TEXT("/PDFImporter/") + Filename + TEXT("/"), AbsolutePackagePath);
+
+	const FString PackagePath = GetTexturePackageName(Filename, PackageIndex);
+	UPackage* Package = CreatePackage(nullptr, *PackagePath);
+	Package->FullyLoad();
+
+	// eNX`쐬
+	FName TextureName = MakeUniqueObjectName(Package, UTexture2D::StaticClass(), FName(AssetName.IsEmpty() ? *Filename : *AssetName));
+	UTexture2D* NewTexture = NewObject<UTexture2D>(Package, TextureName, RF_Public | RF_Standalone);
+
+	// eNX`̐ݒ
+	NewTexture->MipGenSettings = TextureMipGenSettings::TMGS_NoMipmaps;
+	NewTexture->NeverStream = false;
+	NewTexture->AddToRoot();
+
+	// sNZf[^eNX`ɏ
+	WriteBitmapToTextureAsset(Bitmap, Compression, bVirtualTexture, NewTexture);
+
+	// pbP[W͌ĂяoőSẴy[W쐬Ăۑ
+	FAssetRegistryModule::AssetCreated(NewTexture);
+	LoadedTexture = NewTexture;
+
+	return true;
+}
+
+void FGhostscriptCore::WriteBitmapToTextureAsset(const FPageBitmap& Bitmap, EPDFPageCompression Compression, bool bVirtualTexture, UTexture2D* Texture)
+{
+	int Width = Bitmap.Width;
+	int Height = Bitmap.Height;
+
+	// zeNX`̃^C̓GW쐬̂ňkȂꍇ@ō쐬
+	if (Compression != EPDFPageCompression::Uncompressed || bVirtualTexture)
 	{
-		// 񈳏k̉摜f[^擾
-		const TArray<uint8>* UncompressedRawData = nullptr;
-		if (ImageWrapper.IsValid() &&
-			ImageWrapper->SetCompressed(RawFileData.GetData(), RawFileData.Num()) &&
-			ImageWrapper->GetRaw(ERGBFormat::BGRA, 8, UncompressedRawData)
-			)
+		// ăC|[gŏꍇ͌Â\[XĂ
+		if (Texture->PlatformData != nullptr)
 		{
-			FString Filename = FPaths::GetBaseFilename(FilePath);
-			Filename = Filename.Left(Filename.Len() - 10);
-			int Width = ImageWrapper->GetWidth();
-			int Height = ImageWrapper->GetHeight();
+			Texture->ReleaseResource();
+		}
 
-			// pbP[W쐬
-			FString PackagePath(TEXT("/PDFImporter/") + Filename + TEXT("/"));
-			FString AbsolutePackagePath = PagesDirectoryPath + TEXT("/") + Filename + TEXT("/");
+		// y[W͕sȂ̂ŃAt@ȂTC_DefaultBC1ňk
+		// TC_VectorDisplacementmap͈kȂBGRA8ɂȂ
+		switch (Compression)
+		{
+		case EPDFPageCompression::BC1:			Texture->CompressionSettings = TC_Default; break;
+		case EPDFPageCompression::BC7:			Texture->CompressionSettings = TC_BC7; break;
+		default:								Texture->CompressionSettings = TC_VectorDisplacementmap; break;
+		}
+		Texture->CompressionNoAlpha = true;
+		Texture->MipGenSettings = TextureMipGenSettings::TMGS_SimpleAverage;
+#if ENGINE_MINOR_VERSION >= 23
+		Texture->VirtualTextureStreaming = bVirtualTexture;
+#endif
+		Texture->Source.Init(Width, Height, 1, 1, ETextureSourceFormat::TSF_BGRA8, Bitmap.Pixels.GetData());
 
-			FPackageName::RegisterMountPoint(PackagePath, AbsolutePackagePath);
+		// ~bv}bv̍쐬ƈk̓GW̃[J[Xbhōs
+		Texture->CachePlatformData(true, true);
+		Texture->MarkPackageDirty();
+		return;
+	}
 
-			PackagePath += Filename;
+	// ăC|[gŏꍇ͌Â\[XĂ
+	if (Texture->PlatformData == nullptr)
+	{
+		Texture->PlatformData = new FTexturePlatformData();
+	}
+	else
+	{
+		Texture->ReleaseResource();
+		Texture->PlatformData->Mips.Empty();
+	}
+	Texture->PlatformData->SizeX = Width;
+	Texture->PlatformData->SizeY = Height;
 
-			UPackage* Package = CreatePackage(nullptr, *PackagePath);
-			Package->FullyLoad();
+	FTexture2DMipMap* Mip = new FTexture2DMipMap();
+	Texture->PlatformData->Mips.Add(Mip);
+	Mip->SizeX = Width;
+	Mip->SizeY = Height;
+	Mip->BulkData.Lock(LOCK_READ_WRITE);
+	uint8* TextureData = (uint8*)Mip->BulkData.Realloc(Bitmap.Pixels.Num());
+	FMemory::Memcpy(TextureData, Bitmap.Pixels.GetData(), Bitmap.Pixels.Num());
+	Mip->BulkData.Unlock();
 
-			// eNX`쐬
-			FName TextureName = MakeUniqueObjectName(Package, UTexture2D::StaticClass(), FName(*Filename));
-			UTexture2D* NewTexture = NewObject<UTexture2D>(Package, TextureName, RF_Public | RF_Standalone);
+	// eNX`XV
+	Texture->Source.Init(Width, Height, 1, 1, ETextureSourceFormat::TSF_BGRA8, Bitmap.Pixels.GetData());
+	Texture->UpdateResource();
+	Texture->MarkPackageDirty();
+}
 
-			// eNX`̐ݒ
-			NewTexture->PlatformData = new FTexturePlatformData();
-			NewTexture->PlatformData->SizeX = Width;
-			NewTexture->PlatformData->SizeY = Height;
-			NewTexture->MipGenSettings = TextureMipGenSettings::TMGS_NoMipmaps;
-			NewTexture->NeverStream = false;
+bool FGhostscriptCore::BuildThumbnailAtlases(const FString& InputPath, int FirstPage, int LastPage, const FString& Filename,
+	TArray<UTexture2D*>& OutAtlases, TArray<FPDFPageThumbnail>& OutThumbnails)
+{
+	OutAtlases.Reset();
+	OutThumbnails.Reset();
 
-			// sNZf[^eNX`ɏ
-			FTexture2DMipMap* Mip = new FTexture2DMipMap();
-			NewTexture->PlatformData->Mips.Add(Mip);
-			Mip->SizeX = Width;
-			Mip->SizeY = Height;
-			Mip->BulkData.Lock(LOCK_READ_WRITE);
-			uint8* TextureData = (uint8*)Mip->BulkData.Realloc(UncompressedRawData->Num());
-			FMemory::Memcpy(TextureData, UncompressedRawData->GetData(), UncompressedRawData->Num());
-			Mip->BulkData.Unlock();
+	const UPDFImporterSettings* Settings = GetDefault<UPDFImporterSettings>();
+	if (Settings->ThumbnailDpi <= 0)
+	{
+		return true;
+	}
 
-			// eNX`XV
-			NewTexture->AddToRoot();
-			NewTexture->Source.Init(Width, Height, 1, 1, ETextureSourceFormat::TSF_BGRA8, UncompressedRawData->GetData());
-			NewTexture->UpdateResource();
+	// SẴy[WႢ𑜓xňxɕ`悵ċl߂Ă
+	FThumbnailAtlasBuilder Builder(FMath::Min(Settings->ThumbnailAtlasSize, (int)GetMax2DTextureDimension()));
+	if (!ConvertPdfToBitmaps(InputPath, Settings->ThumbnailDpi, FirstPage, LastPage, [&](int PageNumber, FPageBitmap& Bitmap)
+	{
+		Builder.Add(Bitmap);
+		return true;
+	}))
+	{
+		return false;
+	}
 
-			// pbP[Wۑ
-			Package->MarkPackageDirty();
-			FAssetRegistryModule::AssetCreated(NewTexture);
-			LoadedTexture = NewTexture;
+	TArray<FPageBitmap> AtlasBitmaps;
+	Builder.Finish(AtlasBitmaps, OutThumbnails);
 
-			FString PackageFilename = FPackageName::LongPackageNameToFilename(PackagePath, FPackageName::GetAssetPackageExtension());
-			return UPackage::SavePackage(Package, NewTexture, RF_Public | RF_Standalone, *PackageFilename, GError, nullptr, true, true, SAVE_NoError);
+	// TlC͏kĕ\̂Ńy[ẄkݒɊւ炸BC1ŕۑ
+	const FString AtlasName = Filename + TEXT("_Thumbnails");
+	for (const FPageBitmap& AtlasBitmap : AtlasBitmaps)
+	{
+		UTexture2D* NewAtlas;
+		if (!CreateTextureAssetFromBitmap(AtlasBitmap, Filename, EPDFPageCompression::BC1, false, NewAtlas, ThumbnailPackageIndex, AtlasName))
+		{
+			FinishTextureAssets(OutAtlases, EPDFPageCompression::BC1, false);
+			DiscardTextureAssets(OutAtlases);
+			OutAtlases.Reset();
+			OutThumbnails.Reset();
+			return false;
 		}
+		OutAtlases.Add(NewAtlas);
 	}
 
-	return false;
+	FinishTextureAssets(OutAtlases, EPDFPageCompression::BC1, false);
+	return true;
+}
+
+void FGhostscriptCore::FinishTextureAssets(const TArray<UTexture2D*>& Textures, EPDFPageCompression Compression, bool bVirtualTexture)
+{
+	if (Compression == EPDFPageCompression::Uncompressed && !bVirtualTexture)
+	{
+		return;
+	}
+
+	for (UTexture2D* Texture : Textures)
+	{
+		Texture->FinishCachePlatformData();
+		Texture->UpdateResource();
+	}
+}
+
+FString FGhostscriptCore::GetTexturePackageName(const FString& Filename, int PackageIndex)
+{
+	const FString PackagePath = TEXT("/PDFImporter/") + Filename + TEXT("/");
+	if (PackageIndex == ThumbnailPackageIndex)
+	{
+		return PackagePath + Filename + TEXT("_Thumbnails");
+	}
+
+	// ŏ̃pbP[W͈ȑOƓOɂĊ̃AZbgɒǉł悤ɂ
+	return PackagePath + ((PackageIndex > 0) ? FString::Printf(TEXT("%s_%d"), *Filename, PackageIndex) : Filename);
+}
+
+int FGhostscriptCore::GetPagePackageIndex(int PageIndex)
+{
+	// 0̏ꍇ͑SẴy[W1̃pbP[Wɂ܂Ƃ߂
+	const int PagesPerPackage = GetDefault<UPDFImporterSettings>()->PagesPerPackage;
+	return PagesPerPackage > 0 ? PageIndex / PagesPerPackage : 0;
+}
+
+bool FGhostscriptCore::SaveTextureAssetPackage(UTexture2D* Texture, bool bAsyncWrite)
+{
+	UPackage* Package = Texture->GetOutermost();
+	FString PackageFilename = FPackageName::LongPackageNameToFilename(Package->GetName(), FPackageName::GetAssetPackageExtension());
+	const uint32 SaveFlags = bAsyncWrite ? SAVE_NoError | SAVE_Async : SAVE_NoError;
+	return UPackage::SavePackage(Package, Texture, RF_Public | RF_Standalone, *PackageFilename, GError, nullptr, true, true, SaveFlags);
+}
+
+bool FGhostscriptCore::SaveTextureAssetPackages(const TArray<UTexture2D*>& Textures, double* OutWriteSeconds)
+{
+	// VACY̓Q[XbhŏԂɍsAt@Cւ݂͎̏̃pbP[W̃VACYƕs
+	TSet<UPackage*> SavedPackages;
+	bool bIsSaved = true;
+	for (UTexture2D* Texture : Textures)
+	{
+		if (Texture != nullptr && !SavedPackages.Contains(Texture->GetOutermost()))
+		{
+			SavedPackages.Add(Texture->GetOutermost());
+			bIsSaved &= SaveTextureAssetPackage(Texture, true);
+		}
+	}
+
+	// ĂяopbP[W̃t@C폜ǂݍ񂾂肷OɑSĂ݂̏I点
+	const double WriteStartTime = FPlatformTime::Seconds();
+	UPackage::WaitForAsyncFileWrites();
+	if (OutWriteSeconds != nullptr)
+	{
+		*OutWriteSeconds = FPlatformTime::Seconds() - WriteStartTime;
+	}
+
+	return bIsSaved;
+}
+
+void FGhostscriptCore::DiscardPdfAsset(UPDF* PDFAsset)
+{
+	TArray<UTexture2D*> Textures;
+	for (UTexture2D* Texture : PDFAsset->Pages)
+	{
+		if (Texture != nullptr)
+		{
+			Textures.Add(Texture);
+		}
+	}
+	for (UTexture2D* Atlas : PDFAsset->ThumbnailAtlases)
+	{
+		if (Atlas != nullptr)
+		{
+			Textures.Add(Atlas);
+		}
+	}
+
+	DiscardTextureAssets(Textures);
+	PDFAsset->Pages.Reset();
+	PDFAsset->ThumbnailAtlases.Reset();
+	PDFAsset->PageThumbnails.Reset();
+}
+
+void FGhostscriptCore::DiscardTextureAssets(const TArray<UTexture2D*>& Textures)
+{
+	TSet<UPackage*> Packages;
+	for (UTexture2D* Texture : Textures)
+	{
+		Packages.Add(Texture->GetOutermost());
+		Texture->RemoveFromRoot();
+		Texture->ClearFlags(RF_Public | RF_Standalone);
+		Texture->MarkPendingKill();
+		FAssetRegistryModule::AssetDeleted(Texture);
+	}
+
+	for (UPackage* Package : Packages)
+	{
+		// ̃eNX`cĂpbP[W͕ۑAɂȂpbP[W̓t@C폜
+		UTexture2D* RemainingTexture = nullptr;
+		ForEachObjectWithOuter(Package, [&RemainingTexture](UObject* Object)
+		{
+			UTexture2D* Texture = Cast<UTexture2D>(Object);
+			if (Texture != nullptr && !Texture->IsPendingKill())
+			{
+				RemainingTexture = Texture;
+			}
+		}, false);
+
+		if (RemainingTexture != nullptr)
+		{
+			SaveTextureAssetPackage(RemainingTexture);
+		}
+		else
+		{
+			IFileManager::Get().Delete(*FPackageName::LongPackageNameToFilename(Package->GetName(), FPackageName::GetAssetPackageExtension()), false, false, true);
+		}
+	}
 }
 #endif
 
@@ -315,6 +1584,28 @@ TArray<char> FGhostscriptCore::FStringToCharPtr(const FString& Text)
 	return Buffer;
 }
 
+FString FGhostscriptCore::GetPageBitmapHash(const FPageBitmap& Bitmap) const
+{
+	FMD5 Hash;
+	Hash.Update(reinterpret_cast<const uint8*>(&Bitmap.Width), sizeof(Bitmap.Width));
+	Hash.Update(reinterpret_cast<const uint8*>(&Bitmap.Height), sizeof(Bitmap.Height));
+	Hash.Update(Bitmap.Pixels.GetData(), Bitmap.Pixels.Num());
+
+	FMD5Hash Result;
+	Result.Set(Hash);
+	return LexToString(Result);
+}
+
+bool FGhostscriptCore::CanUseVirtualTextures() const
+{
+	// zeNX`UE4.23gAvWFNgݒŗLɂKv
+#if WITH_EDITORONLY_DATA && ENGINE_MINOR_VERSION >= 23
+	return UseVirtualTexturing(GMaxRHIFeatureLevel);
+#else
+	return false;
+#endif
+}
+
 int FGhostscriptCore::GetFStringSize(const FString& InString)
 {
 	int Size = 0;
@@ -2,20 +2,37 @@
 
 #include "PDF.h"
 #include "PDFImporter.h"
+#include "PDFImporterSettings.h"
+#include "GhostscriptCore.h"
+#include "PDFPageCache.h"
+#include "PageTextureEncoder.h"
+#include "PageTextureUploader.h"
+#include "AsyncExecTask.h"
+#include "Async/Async.h"
 #include "Misc/Paths.h"
 #include "Engine//Texture2D.h"
+#include "Engine/AssetManager.h"
 #include "Serialization/CustomVersion.h"
 
 #if WITH_EDITORONLY_DATA
 #include "EditorFramework/AssetImportData.h"
 #endif
 
-static const int PDF_Version = 1;
+static const int PDF_Version_Initial = 1;
+static const int PDF_Version_PageHashes = 2;
+static const int PDF_Version_SoftPages = 3;
+static const int PDF_Version = PDF_Version_SoftPages;
 static const FGuid PDF_GUID(2020, 1, 13, 16);
 static FCustomVersionRegistration RegisterPDFCustomVersion(PDF_GUID, PDF_Version, TEXT("PDFVersion"));
 
 UTexture2D* UPDF::GetPageTexture(int Page) const
 {
+	if (Pages.Num() == 0)
+	{
+		UE_LOG(PDFImporter, Warning, TEXT("PDF has no pages"));
+		return nullptr;
+	}
+
 	if (Page < 1)
 	{
 		Page = 1;
@@ -27,17 +44,114 @@ UTexture2D* UPDF::GetPageTexture(int Page) const
 		UE_LOG(PDFImporter, Warning, TEXT("The specified page exceeds the number of pages in the PDF"));
 	}
 
+	if (bRenderPagesOnDemand)
+	{
+		// 要求されたページを描画するのでBlueprintからはconstのまま呼べるようにする
+		return const_cast<UPDF*>(this)->LoadPage(Page - 1);
+	}
+
+	if (PageAssets.IsValidIndex(Page - 1))
+	{
+		return const_cast<UPDF*>(this)->LoadPageAsset(Page - 1);
+	}
+
 	return Pages[Page - 1];
 }
 
+UTexture2D* UPDF::FindPageTexture(int Page) const
+{
+	if (!Pages.IsValidIndex(Page - 1))
+	{
+		return nullptr;
+	}
+
+	// 他から読み込まれているページアセットも返す
+	if (Pages[Page - 1] == nullptr && PageAssets.IsValidIndex(Page - 1))
+	{
+		return PageAssets[Page - 1].Get();
+	}
+
+	return Pages[Page - 1];
+}
+
+bool UPDF::GetPageInfo(int Page, FPDFPageInfo& OutInfo) const
+{
+	if (!PageInfos.IsValidIndex(Page - 1) || PageInfos[Page - 1].Width <= 0)
+	{
+		return false;
+	}
+
+	OutInfo = PageInfos[Page - 1];
+	return true;
+}
+
+void UPDF::LoadAllPages()
+{
+	// 全てのページを変更する間に解放されないようにページキャッシュから外す
+	FPDFImporterModule& PDFImporterModule = FModuleManager::LoadModuleChecked<FPDFImporterModule>(FName("PDFImporter"));
+	PDFImporterModule.GetPageCache()->RemovePDF(this);
+
+	for (int PageIndex = 0; PageIndex < Pages.Num(); PageIndex++)
+	{
+		if (Pages[PageIndex] == nullptr && PageAssets.IsValidIndex(PageIndex))
+		{
+			Pages[PageIndex] = PageAssets[PageIndex].LoadSynchronous();
+		}
+	}
+}
+
+bool UPDF::GetPageThumbnail(int Page, UTexture2D*& OutAtlas, FVector2D& OutUVOffset, FVector2D& OutUVSize) const
+{
+	if (!PageThumbnails.IsValidIndex(Page - 1))
+	{
+		return false;
+	}
+
+	const FPDFPageThumbnail& Thumbnail = PageThumbnails[Page - 1];
+	if (!ThumbnailAtlases.IsValidIndex(Thumbnail.AtlasIndex) || ThumbnailAtlases[Thumbnail.AtlasIndex] == nullptr)
+	{
+		return false;
+	}
+
+	OutAtlas = ThumbnailAtlases[Thumbnail.AtlasIndex];
+	OutUVOffset = Thumbnail.UVOffset;
+	OutUVSize = Thumbnail.UVSize;
+	return true;
+}
+
 void UPDF::Serialize(FArchive& Ar)
 {
+	// 読み込まれているページから保存するページアセットを更新する
+	if (Ar.IsSaving())
+	{
+		UpdatePageAssets();
+	}
+
 	Super::Serialize(Ar);
 
 	Ar.UsingCustomVersion(PDF_GUID);
-	if (Ar.IsSaving() || (Ar.IsLoading() && (PDF_Version <= Ar.CustomVer(PDF_GUID))))
+	if (Ar.IsLoading() && Ar.CustomVer(PDF_GUID) < PDF_Version_SoftPages)
+	{
+		// 古いアセットはテクスチャを直接参照しているので読み込んでからPostLoadで変換する
+		if (PDF_Version_Initial <= Ar.CustomVer(PDF_GUID))
+		{
+			Ar << PageRange.FirstPage << PageRange.LastPage << Dpi << Pages << Filename << TimeStamp;
+		}
+	}
+	else
 	{
-		Ar << PageRange.FirstPage << PageRange.LastPage << Dpi << Pages << Filename << TimeStamp;
+		// ページのテクスチャは要求された時に読み込む
+		Ar << PageRange.FirstPage << PageRange.LastPage << Dpi << PageAssets << PageInfos << Filename << TimeStamp;
+		if (Ar.IsLoading())
+		{
+			Pages.SetNumZeroed(PageAssets.Num());
+		}
+	}
+
+	// 古いアセットにはページのハッシュがないので再インポート時に全てのページを更新する
+	if (Ar.IsSaving() || (Ar.IsLoading() && (PDF_Version_PageHashes <= Ar.CustomVer(PDF_GUID))))
+	{
+		Ar << PageHashes;
 	}
 }
 
@@ -56,6 +170,37 @@ void UPDF::PostLoad()
 {
 	Super::PostLoad();
 
+	// 古いアセットは次に保存する時にページアセットとして保存する
+	if (PageAssets.Num() != Pages.Num())
+	{
+		for (UTexture2D* Page : Pages)
+		{
+			if (Page != nullptr)
+			{
+				Page->ConditionalPostLoad();
+			}
+		}
+		UpdatePageAssets();
+	}
+
+	// アトラスがページと同じパッケージにある古いアセットは読み込むだけでページのテクスチャも読み込まれる
+	// 再インポートするとアトラスが専用のパッケージに移る
+	for (UTexture2D* Atlas : ThumbnailAtlases)
+	{
+		if (Atlas != nullptr && !Atlas->GetOutermost()->GetName().EndsWith(TEXT("_Thumbnails")))
+		{
+			UE_LOG(PDFImporter, Warning, TEXT("%s loads page textures with its thumbnails, reimport it to load the pages on demand"), *GetPathName());
+			break;
+		}
+	}
+
+	// 仮想テクスチャのページはキャンバスやUMGで描画できない
+	// 再インポートすると通常のテクスチャに作り直される
+	if (bVirtualTexturePages)
+	{
+		UE_LOG(PDFImporter, Warning, TEXT("%s stores its pages as virtual textures that can not be drawn on a canvas or a brush, reimport it to store them as regular textures"), *GetPathName());
+	}
+
 #if WITH_EDITORONLY_DATA
 	if (AssetImportData == nullptr)
 	{
@@ -65,14 +210,367 @@ void UPDF::PostLoad()
 #endif
 }
 
+void UPDF::BeginDestroy()
+{
+	// モジュールが先に破棄されている場合がある
+	FPDFImporterModule* PDFImporterModule = FModuleManager::GetModulePtr<FPDFImporterModule>(FName("PDFImporter"));
+	if (PDFImporterModule != nullptr && PDFImporterModule->GetPageCache().IsValid())
+	{
+		PDFImporterModule->GetPageCache()->RemovePDF(this);
+	}
+
+	Super::BeginDestroy();
+}
+
 #if WITH_EDITORONLY_DATA
 void UPDF::GetAssetRegistryTags(TArray<FAssetRegistryTag>& OutTags) const
 {
 	if (AssetImportData)
 	{
 		OutTags.Add(FAssetRegistryTag(SourceFileTagName(), AssetImportData->GetSourceData().ToJson(), FAssetRegistryTag::TT_Hidden));
+
+		// ソースファイルが変わっていないかをアセットを読み込まずに確認できるように
+		const FAssetImportInfo& SourceData = AssetImportData->GetSourceData();
+		if (SourceData.SourceFiles.Num() > 0 && SourceData.SourceFiles[0].FileHash.IsValid())
+		{
+			OutTags.Add(FAssetRegistryTag(TEXT("SourceHash"), LexToString(SourceData.SourceFiles[0].FileHash), FAssetRegistryTag::TT_Alphabetical));
+		}
+	}
+
+	// ページ数やメモリ量を調べるためにページのテクスチャを読み込まなくて済むように
+	const int PageCount = FMath::Max(PageInfos.Num(), Pages.Num());
+	OutTags.Add(FAssetRegistryTag(TEXT("PageCount"), FString::FromInt(PageCount), FAssetRegistryTag::TT_Numerical));
+	OutTags.Add(FAssetRegistryTag(TEXT("FirstPage"), FString::FromInt(PageRange.FirstPage), FAssetRegistryTag::TT_Numerical));
+	OutTags.Add(FAssetRegistryTag(TEXT("LastPage"), FString::FromInt(PageRange.LastPage), FAssetRegistryTag::TT_Numerical));
+	OutTags.Add(FAssetRegistryTag(TEXT("Dpi"), FString::FromInt(Dpi), FAssetRegistryTag::TT_Numerical));
+
+	// ページの大きさは重複を除いた "幅x高さ" をカンマで区切って並べ、ページ数が多くてもタグが大きくならないように数を制限する
+	static const int MaxPageDimensions = 16;
+	int MaxPageWidth = 0;
+	int MaxPageHeight = 0;
+	int64 ResidentBytes = 0;
+	TArray<FIntPoint> PageDimensions;
+	for (const FPDFPageInfo& PageInfo : PageInfos)
+	{
+		MaxPageWidth = FMath::Max(MaxPageWidth, PageInfo.Width);
+		MaxPageHeight = FMath::Max(MaxPageHeight, PageInfo.Height);
+		ResidentBytes += PageInfo.SizeBytes;
+		if (PageDimensions.Num() < MaxPageDimensions)
+		{
+			PageDimensions.AddUnique(FIntPoint(PageInfo.Width, PageInfo.Height));
+		}
+	}
+
+	TArray<FString> PageDimensionTexts;
+	for (const FIntPoint& PageDimension : PageDimensions)
+	{
+		PageDimensionTexts.Add(FString::Printf(TEXT("%dx%d"), PageDimension.X, PageDimension.Y));
 	}
-	
+
+	// サムネイルはPDFと一緒に常に読み込まれる
+	for (UTexture2D* ThumbnailAtlas : ThumbnailAtlases)
+	{
+		if (ThumbnailAtlas != nullptr)
+		{
+			ResidentBytes += ThumbnailAtlas->CalcTextureMemorySizeEnum(TMC_AllMips);
+		}
+	}
+
+	OutTags.Add(FAssetRegistryTag(TEXT("MaxPageWidth"), FString::FromInt(MaxPageWidth), FAssetRegistryTag::TT_Numerical));
+	OutTags.Add(FAssetRegistryTag(TEXT("MaxPageHeight"), FString::FromInt(MaxPageHeight), FAssetRegistryTag::TT_Numerical));
+	OutTags.Add(FAssetRegistryTag(TEXT("PageDimensions"), FString::Join(PageDimensionTexts, TEXT(",")), FAssetRegistryTag::TT_Alphabetical));
+	OutTags.Add(FAssetRegistryTag(TEXT("ResidentBytes"), LexToString(ResidentBytes), FAssetRegistryTag::TT_Numerical));
+
 	Super::GetAssetRegistryTags(OutTags);
 }
 #endif
+
+UTexture2D* UPDF::LoadPage(int PageIndex)
+{
+	FPDFImporterModule& PDFImporterModule = FModuleManager::LoadModuleChecked<FPDFImporterModule>(FName("PDFImporter"));
+	TSharedPtr<FPDFPageCache> PageCache = PDFImporterModule.GetPageCache();
+
+	if (Pages[PageIndex] != nullptr)
+	{
+		PageCache->NotifyHit(this, PageIndex);
+	}
+	else
+	{
+		PageCache->NotifyMiss();
+		TSharedPtr<FGhostscriptCore> GhostscriptCore = PDFImporterModule.GetGhostscriptCore();
+
+		// 要求されたページだけを描画
+		const int PageNumber = PageRange.FirstPage + PageIndex;
+		GhostscriptCore->ConvertPdfToBitmaps(Filename, Dpi, PageNumber, PageNumber, [&](int RenderedPageNumber, FPageBitmap& Bitmap)
+		{
+			FGhostscriptCore::FitBitmapToMaxTextureSize(Bitmap);
+
+			UTexture2D* Texture;
+			if (GhostscriptCore->LoadTexture2DFromBitmap(Bitmap, Texture, Compression))
+			{
+				Pages[PageIndex] = Texture;
+			}
+			return true;
+		});
+
+		if (Pages[PageIndex] == nullptr)
+		{
+			UE_LOG(PDFImporter, Error, TEXT("Failed to render page %d of %s"), PageNumber, *Filename);
+		}
+		else
+		{
+			PageCache->AddPage(this, PageIndex, Pages[PageIndex]);
+		}
+	}
+
+	// 続くページを先に描画しておく
+	const int NumPrefetchPages = GetDefault<UPDFImporterSettings>()->PrefetchPages;
+	if (NumPrefetchPages > 0)
+	{
+		StartPrefetch(PageIndex + 1, FMath::Min(PageIndex + NumPrefetchPages, Pages.Num() - 1));
+	}
+
+	return Pages[PageIndex];
+}
+
+void UPDF::PrefetchPages(int FirstPage, int LastPage)
+{
+	if (Pages.Num() == 0)
+	{
+		return;
+	}
+
+	if (bRenderPagesOnDemand)
+	{
+		StartPrefetch(FMath::Max(FirstPage, 1) - 1, FMath::Min(LastPage, Pages.Num()) - 1);
+	}
+	else if (PageAssets.Num() > 0)
+	{
+		StartPageAssetLoad(FMath::Max(FirstPage, 1) - 1, FMath::Min(LastPage, PageAssets.Num()) - 1);
+	}
+}
+
+void UPDF::StartPrefetch(int FirstIndex, int LastIndex)
+{
+	// 描画済みと描画中のページを除く
+	while (FirstIndex <= LastIndex && (Pages[FirstIndex] != nullptr || PrefetchingPages.Contains(FirstIndex)))
+	{
+		FirstIndex++;
+	}
+	while (LastIndex >= FirstIndex && (Pages[LastIndex] != nullptr || PrefetchingPages.Contains(LastIndex)))
+	{
+		LastIndex--;
+	}
+	if (FirstIndex > LastIndex)
+	{
+		return;
+	}
+
+	for (int PageIndex = FirstIndex; PageIndex <= LastIndex; PageIndex++)
+	{
+		PrefetchingPages.Add(PageIndex);
+	}
+
+	FPDFImporterModule& PDFImporterModule = FModuleManager::LoadModuleChecked<FPDFImporterModule>(FName("PDFImporter"));
+	TSharedPtr<FGhostscriptCore> GhostscriptCore = PDFImporterModule.GetGhostscriptCore();
+	TWeakObjectPtr<UPDF> WeakThis(this);
+	const FString InputPath = Filename;
+	const int RenderDpi = Dpi;
+	const EPDFPageCompression PageCompression = Compression;
+	const int FirstPageNumber = PageRange.FirstPage + FirstIndex;
+	const int LastPageNumber = PageRange.FirstPage + LastIndex;
+
+	TSharedPtr<FPageTextureUploader> TextureUploader = PDFImporterModule.GetTextureUploader();
+
+	// テクスチャはゲームスレッドでしか作成できないので画像の描画と圧縮だけをバックグラウンドで行う
+	auto PrefetchTask = new FAutoDeleteAsyncTask<FAsyncExecTask>([GhostscriptCore, TextureUploader, WeakThis, InputPath, RenderDpi, PageCompression, FirstPageNumber, LastPageNumber, FirstIndex, LastIndex]()
+	{
+		TSet<int> EnqueuedPages;
+		GhostscriptCore->ConvertPdfToBitmaps(InputPath, RenderDpi, FirstPageNumber, LastPageNumber, [&](int PageNumber, FPageBitmap& Bitmap)
+		{
+			FGhostscriptCore::FitBitmapToMaxTextureSize(Bitmap);
+
+			TSharedRef<FPageTextureData, ESPMode::ThreadSafe> TextureData = MakeShared<FPageTextureData, ESPMode::ThreadSafe>();
+			FPageTextureEncoder::Encode(Bitmap, PageCompression, *TextureData);
+			const int PageIndex = FirstIndex + PageNumber - FirstPageNumber;
+			EnqueuedPages.Add(PageIndex);
+
+			// 一度に多くのページが届いてもフレームが止まらないように少しずつテクスチャにする
+			TextureUploader->Enqueue(TextureData, [WeakThis, PageIndex](UTexture2D* Texture)
+			{
+				if (UPDF* PDF = WeakThis.Get())
+				{
+					PDF->OnPagePrefetched(PageIndex, Texture);
+				}
+			});
+			return true;
+		});
+
+		// 描画に失敗したページも再び要求できるようにする
+		// テクスチャの作成を待っているページはOnPagePrefetchedで取り除く
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, FirstIndex, LastIndex, EnqueuedPages]()
+		{
+			if (UPDF* PDF = WeakThis.Get())
+			{
+				for (int PageIndex = FirstIndex; PageIndex <= LastIndex; PageIndex++)
+				{
+					if (!EnqueuedPages.Contains(PageIndex))
+					{
+						PDF->PrefetchingPages.Remove(PageIndex);
+					}
+				}
+			}
+		});
+	});
+
+	PrefetchTask->StartBackgroundTask();
+}
+
+void UPDF::OnPagePrefetched(int PageIndex, UTexture2D* Texture)
+{
+	PrefetchingPages.Remove(PageIndex);
+
+	// 先に同期的に描画されていれば何もしない
+	if (!Pages.IsValidIndex(PageIndex) || Pages[PageIndex] != nullptr || Texture == nullptr)
+	{
+		return;
+	}
+
+	FPDFImporterModule& PDFImporterModule = FModuleManager::LoadModuleChecked<FPDFImporterModule>(FName("PDFImporter"));
+	Pages[PageIndex] = Texture;
+	PDFImporterModule.GetPageCache()->AddPage(this, PageIndex, Texture);
+}
+
+UTexture2D* UPDF::LoadPageAsset(int PageIndex)
+{
+	FPDFImporterModule& PDFImporterModule = FModuleManager::LoadModuleChecked<FPDFImporterModule>(FName("PDFImporter"));
+	TSharedPtr<FPDFPageCache> PageCache = PDFImporterModule.GetPageCache();
+
+	if (Pages[PageIndex] != nullptr)
+	{
+		PageCache->NotifyHit(this, PageIndex);
+		return Pages[PageIndex];
+	}
+
+	PageCache->NotifyMiss();
+	if (PageAssets[PageIndex].IsNull())
+	{
+		return nullptr;
+	}
+
+	// 非同期で読み込み中でも待たずに読み込む
+	UTexture2D* Texture = PageAssets[PageIndex].LoadSynchronous();
+	if (Texture == nullptr)
+	{
+		UE_LOG(PDFImporter, Error, TEXT("Failed to load page texture %s"), *PageAssets[PageIndex].ToString());
+		return nullptr;
+	}
+
+	Pages[PageIndex] = Texture;
+	PageCache->AddPage(this, PageIndex, Texture);
+	return Texture;
+}
+
+void UPDF::StartPageAssetLoad(int FirstIndex, int LastIndex)
+{
+	FPDFImporterModule& PDFImporterModule = FModuleManager::LoadModuleChecked<FPDFImporterModule>(FName("PDFImporter"));
+	TSharedPtr<FPDFPageCache> PageCache = PDFImporterModule.GetPageCache();
+
+	TArray<FSoftObjectPath> AssetPaths;
+	TArray<int> PageIndexes;
+	for (int PageIndex = FirstIndex; PageIndex <= LastIndex; PageIndex++)
+	{
+		if (Pages[PageIndex] != nullptr || PrefetchingPages.Contains(PageIndex) || PageAssets[PageIndex].IsNull())
+		{
+			continue;
+		}
+
+		// 既にメモリにあるページは参照するだけ
+		if (UTexture2D* Texture = PageAssets[PageIndex].Get())
+		{
+			Pages[PageIndex] = Texture;
+			PageCache->AddPage(this, PageIndex, Texture);
+			continue;
+		}
+
+		AssetPaths.Add(PageAssets[PageIndex].ToSoftObjectPath());
+		PageIndexes.Add(PageIndex);
+	}
+
+	if (AssetPaths.Num() == 0)
+	{
+		return;
+	}
+
+	// アセットマネージャーがない場合はその場で読み込む
+	if (!UAssetManager::IsValid())
+	{
+		for (int PageIndex : PageIndexes)
+		{
+			LoadPageAsset(PageIndex);
+		}
+		return;
+	}
+
+	for (int PageIndex : PageIndexes)
+	{
+		PrefetchingPages.Add(PageIndex);
+	}
+	UAssetManager::GetStreamableManager().RequestAsyncLoad(AssetPaths, FStreamableDelegate::CreateUObject(this, &UPDF::OnPageAssetsLoaded, PageIndexes));
+}
+
+void UPDF::OnPageAssetsLoaded(TArray<int> PageIndexes)
+{
+	FPDFImporterModule& PDFImporterModule = FModuleManager::LoadModuleChecked<FPDFImporterModule>(FName("PDFImporter"));
+	TSharedPtr<FPDFPageCache> PageCache = PDFImporterModule.GetPageCache();
+
+	for (int PageIndex : PageIndexes)
+	{
+		PrefetchingPages.Remove(PageIndex);
+
+		// 先に同期的に読み込まれていれば何もしない
+		if (!Pages.IsValidIndex(PageIndex) || Pages[PageIndex] != nullptr || !PageAssets.IsValidIndex(PageIndex))
+		{
+			continue;
+		}
+
+		UTexture2D* Texture = PageAssets[PageIndex].Get();
+		if (Texture == nullptr)
+		{
+			UE_LOG(PDFImporter, Error, TEXT("Failed to load page texture %s"), *PageAssets[PageIndex].ToString());
+			continue;
+		}
+
+		Pages[PageIndex] = Texture;
+		PageCache->AddPage(this, PageIndex, Texture);
+	}
+}
+
+void UPDF::UpdatePageAssets()
+{
+	// 実行時に描画したPDFのテクスチャはアセットではないので保存しない
+	if (bRenderPagesOnDemand)
+	{
+		return;
+	}
+
+	// ページ数はPagesに合わせ、読み込まれていないページは以前のアセットを残す
+	PageAssets.SetNum(Pages.Num());
+	PageInfos.SetNum(Pages.Num());
+	for (int PageIndex = 0; PageIndex < Pages.Num(); PageIndex++)
+	{
+		UTexture2D* Texture = Pages[PageIndex];
+		if (Texture == nullptr)
+		{
+			continue;
+		}
+
+		PageAssets[PageIndex] = Texture;
+
+		FPDFPageInfo& PageInfo = PageInfos[PageIndex];
+		PageInfo.Width = Texture->GetSizeX();
+		PageInfo.Height = Texture->GetSizeY();
+		PageInfo.Dpi = Dpi;
+		PageInfo.SizeBytes = (int)FMath::Min<int64>(Texture->CalcTextureMemorySizeEnum(TMC_AllMips), MAX_int32);
+	}
+}
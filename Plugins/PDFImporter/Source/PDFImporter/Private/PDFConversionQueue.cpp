@@ -0,0 +1,180 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "PDFConversionQueue.h"
+#include "GhostscriptCore.h"
+#include "PDFImporter.h"
+#include "PDFImporterSettings.h"
+#include "AsyncExecTask.h"
+#include "Async/Async.h"
+#include "Engine/Texture2D.h"
+
+FPDFConversionTask::FPDFConversionTask(const FPDFConversionOptions& InOptions, EPDFConversionPriority InPriority, const FOnPDFConversionProgress& InOnProgress, const FOnPDFConversionFinished& InOnFinished)
+	: Options(InOptions), Priority(InPriority), OnProgress(InOnProgress), OnFinished(InOnFinished)
+	, bIsCancelled(false), bIsStarted(false), bIsFinished(false)
+{
+}
+
+void FPDFConversionTask::Cancel()
+{
+	bIsCancelled = true;
+
+	// 開始前の変換はワーカーが拾わないのでここで終了させる
+	if (IsInGameThread() && !bIsStarted)
+	{
+		FPDFImporterModule* PDFImporterModule = FModuleManager::GetModulePtr<FPDFImporterModule>(FName("PDFImporter"));
+		if (PDFImporterModule != nullptr && PDFImporterModule->GetConversionQueue().IsValid())
+		{
+			PDFImporterModule->GetConversionQueue()->RemoveCancelledConversions();
+		}
+	}
+}
+
+FPDFConversionQueue::FPDFConversionQueue()
+	: NumRunningTasks(0)
+{
+}
+
+TSharedRef<FPDFConversionTask, ESPMode::ThreadSafe> FPDFConversionQueue::StartConversion(const FPDFConversionOptions& Options, EPDFConversionPriority Priority,
+	const FOnPDFConversionProgress& OnProgress, const FOnPDFConversionFinished& OnFinished)
+{
+	check(IsInGameThread());
+
+	TSharedRef<FPDFConversionTask, ESPMode::ThreadSafe> Task = MakeShareable(new FPDFConversionTask(Options, Priority, OnProgress, OnFinished));
+	WaitingTasks.Add(Task);
+	StartWaitingConversions();
+	return Task;
+}
+
+void FPDFConversionQueue::RemoveCancelledConversions()
+{
+	check(IsInGameThread());
+
+	// 完了通知の中で別の変換がキャンセルされても良いように先に取り除いてから通知する
+	TArray<TSharedRef<FPDFConversionTask, ESPMode::ThreadSafe>> CancelledTasks;
+	for (int Index = WaitingTasks.Num() - 1; Index >= 0; Index--)
+	{
+		if (WaitingTasks[Index]->IsCancelled())
+		{
+			CancelledTasks.Insert(WaitingTasks[Index], 0);
+			WaitingTasks.RemoveAt(Index);
+		}
+	}
+
+	for (const TSharedRef<FPDFConversionTask, ESPMode::ThreadSafe>& Task : CancelledTasks)
+	{
+		Task->bIsFinished = true;
+		Task->OnFinished.ExecuteIfBound(nullptr);
+	}
+}
+
+void FPDFConversionQueue::StartWaitingConversions()
+{
+	const int MaxRunningTasks = GetDefault<UPDFImporterSettings>()->MaxConcurrentConversions;
+	while (WaitingTasks.Num() > 0 && (MaxRunningTasks <= 0 || NumRunningTasks < MaxRunningTasks))
+	{
+		// 優先度の高いものから、同じ優先度なら先に追加されたものから開始する
+		int NextIndex = 0;
+		for (int Index = 1; Index < WaitingTasks.Num(); Index++)
+		{
+			if (WaitingTasks[Index]->GetPriority() > WaitingTasks[NextIndex]->GetPriority())
+			{
+				NextIndex = Index;
+			}
+		}
+
+		TSharedRef<FPDFConversionTask, ESPMode::ThreadSafe> Task = WaitingTasks[NextIndex];
+		WaitingTasks.RemoveAt(NextIndex);
+		if (Task->IsCancelled())
+		{
+			Task->bIsFinished = true;
+			Task->OnFinished.ExecuteIfBound(nullptr);
+			continue;
+		}
+
+		Task->bIsStarted = true;
+		NumRunningTasks++;
+		RunConversion(Task);
+	}
+}
+
+void FPDFConversionQueue::RunConversion(const TSharedRef<FPDFConversionTask, ESPMode::ThreadSafe>& Task)
+{
+	FPDFImporterModule& PDFImporterModule = FModuleManager::LoadModuleChecked<FPDFImporterModule>(FName("PDFImporter"));
+	TSharedPtr<FGhostscriptCore> GhostscriptCore = PDFImporterModule.GetGhostscriptCore();
+
+	// モジュールの終了でキューが先に破棄される場合があるので弱参照で持つ
+	TWeakPtr<FPDFConversionQueue, ESPMode::ThreadSafe> WeakThis = AsShared();
+	auto ConvertTask = new FAutoDeleteAsyncTask<FAsyncExecTask>([WeakThis, Task, GhostscriptCore]()
+	{
+		const FPDFConversionOptions& Options = Task->GetOptions();
+
+		// 進捗はゲームスレッドで通知し、キャンセルされていれば次のページに進まない
+		auto OnProgress = [Task](int NumConvertedPages, int NumPages) -> bool
+		{
+			if (Task->OnProgress.IsBound())
+			{
+				AsyncTask(ENamedThreads::GameThread, [Task, NumConvertedPages, NumPages]()
+				{
+					if (!Task->IsFinished() && !Task->IsCancelled())
+					{
+						Task->OnProgress.Execute(NumConvertedPages, NumPages);
+					}
+				});
+			}
+
+			return !Task->IsCancelled();
+		};
+
+		// 必要になったページだけを描画する場合はページ数だけを調べる
+		UPDF* PDFAsset = nullptr;
+		if (!Task->IsCancelled())
+		{
+			PDFAsset = Options.bRenderPagesOnDemand
+				? GhostscriptCore->OpenPdfAsset(Options.InputPath, Options.Dpi, Options.FirstPage, Options.LastPage, Options.Compression)
+				: GhostscriptCore->ConvertPdfToPdfAsset(Options.InputPath, Options.Dpi, Options.FirstPage, Options.LastPage, false, Options.Compression, false, OnProgress);
+		}
+
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, Task, PDFAsset]()
+		{
+			// キューが破棄されていれば結果を届ける先もない
+			TSharedPtr<FPDFConversionQueue, ESPMode::ThreadSafe> This = WeakThis.Pin();
+			if (This.IsValid())
+			{
+				This->FinishConversion(Task, PDFAsset);
+			}
+		});
+	});
+
+	ConvertTask->StartBackgroundTask();
+}
+
+void FPDFConversionQueue::FinishConversion(const TSharedRef<FPDFConversionTask, ESPMode::ThreadSafe>& Task, UPDF* PDFAsset)
+{
+	check(IsInGameThread());
+
+	// ワーカースレッドで作成したオブジェクトはGCの対象になるようにフラグを外す
+	if (PDFAsset != nullptr)
+	{
+		PDFAsset->ClearInternalFlags(EInternalObjectFlags::Async);
+		for (UTexture2D* Page : PDFAsset->Pages)
+		{
+			if (Page != nullptr)
+			{
+				Page->ClearInternalFlags(EInternalObjectFlags::Async);
+			}
+		}
+		for (UTexture2D* Atlas : PDFAsset->ThumbnailAtlases)
+		{
+			if (Atlas != nullptr)
+			{
+				Atlas->ClearInternalFlags(EInternalObjectFlags::Async);
+			}
+		}
+	}
+
+	NumRunningTasks--;
+	Task->bIsFinished = true;
+	Task->OnFinished.ExecuteIfBound(Task->IsCancelled() ? nullptr : PDFAsset);
+
+	StartWaitingConversions();
+}
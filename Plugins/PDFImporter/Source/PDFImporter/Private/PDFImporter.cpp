@@ -2,16 +2,25 @@
 
 #include "PDFImporter.h"
 #include "GhostscriptCore.h"
+#include "PDFPageCache.h"
+#include "PDFConversionQueue.h"
+#include "PageTextureUploader.h"
 
 #define LOCTEXT_NAMESPACE "FPDFImporterModule"
 
 void FPDFImporterModule::StartupModule()
 {
 	GhostscriptCore = MakeShareable(new FGhostscriptCore());
+	PageCache = MakeShareable(new FPDFPageCache());
+	ConversionQueue = MakeShareable(new FPDFConversionQueue());
+	TextureUploader = MakeShareable(new FPageTextureUploader());
 }
 
 void FPDFImporterModule::ShutdownModule()
 {
+	TextureUploader.Reset();
+	ConversionQueue.Reset();
+	PageCache.Reset();
 	GhostscriptCore.Reset();
 }
 
@@ -2,6 +2,7 @@
 
 #include "PDFImporterBPLibrary.h"
 #include "PDFImporter.h"
+#include "PDFPageCache.h"
 #include "Engine.h"
 #include "Developer/DesktopPlatform/Public/IDesktopPlatform.h"
 #include "Developer/DesktopPlatform/Public/DesktopPlatformModule.h"
@@ -33,6 +34,12 @@ FString UPDFImporterBPLibrary::ConvertFPageRangeToFString(FPageRange InPageRange
 	return FString::FromInt(InPageRange.FirstPage) + TEXT(" - ") + FString::FromInt(InPageRange.LastPage);
 }
 
+FPDFPageCacheStats UPDFImporterBPLibrary::GetPageCacheStats()
+{
+	FPDFImporterModule& PDFImporterModule = FModuleManager::LoadModuleChecked<FPDFImporterModule>(FName("PDFImporter"));
+	return PDFImporterModule.GetPageCache()->GetStats();
+}
+
 void* UPDFImporterBPLibrary::GetWindowHandle()
 {
 	// GfB^̏ꍇ
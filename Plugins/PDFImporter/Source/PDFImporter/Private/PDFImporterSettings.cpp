@@ -0,0 +1,15 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "PDFImporterSettings.h"
+#include "HAL/PlatformMisc.h"
+
+int UPDFImporterSettings::GetNumRenderWorkers() const
+{
+	// 未指定の場合はCPUのコア数だけ並列に変換
+	if (NumRenderWorkers <= 0)
+	{
+		return FMath::Max(FPlatformMisc::NumberOfCores(), 1);
+	}
+
+	return NumRenderWorkers;
+}
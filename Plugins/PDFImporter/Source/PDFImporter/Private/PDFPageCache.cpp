@@ -0,0 +1,130 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "PDFPageCache.h"
+#include "PDF.h"
+#include "PDFImporter.h"
+#include "PDFImporterSettings.h"
+#include "Engine/Texture2D.h"
+
+FPDFPageCache::FPDFPageCache()
+	: UseCounter(0)
+	, ResidentBytes(0)
+{
+}
+
+void FPDFPageCache::NotifyHit(UPDF* PDF, int PageIndex)
+{
+	check(IsInGameThread());
+
+	Stats.Hits++;
+
+	FEntry* Entry = Entries.Find(TPair<const UPDF*, int>(PDF, PageIndex));
+	if (Entry != nullptr)
+	{
+		Entry->LastUsed = ++UseCounter;
+	}
+}
+
+void FPDFPageCache::NotifyMiss()
+{
+	check(IsInGameThread());
+
+	Stats.Misses++;
+}
+
+void FPDFPageCache::AddPage(UPDF* PDF, int PageIndex, UTexture2D* Texture)
+{
+	check(IsInGameThread());
+
+	if (Texture == nullptr)
+	{
+		return;
+	}
+
+	const TPair<const UPDF*, int> Key(PDF, PageIndex);
+	FEntry& Entry = Entries.FindOrAdd(Key);
+	ResidentBytes -= Entry.Size;
+
+	Entry.PDF = PDF;
+	Entry.PageIndex = PageIndex;
+	Entry.Size = Texture->CalcTextureMemorySizeEnum(TMC_AllMips);
+	Entry.LastUsed = ++UseCounter;
+
+	ResidentBytes += Entry.Size;
+
+	EvictToBudget(Key);
+}
+
+void FPDFPageCache::RemovePDF(const UPDF* PDF)
+{
+	for (auto It = Entries.CreateIterator(); It; ++It)
+	{
+		if (It.Key().Key == PDF)
+		{
+			ResidentBytes -= It.Value().Size;
+			It.RemoveCurrent();
+		}
+	}
+}
+
+FPDFPageCacheStats FPDFPageCache::GetStats() const
+{
+	FPDFPageCacheStats Result = Stats;
+	Result.ResidentPages = Entries.Num();
+	Result.ResidentMegabytes = ResidentBytes / (1024.f * 1024.f);
+	return Result;
+}
+
+void FPDFPageCache::EvictToBudget(const TPair<const UPDF*, int>& KeepKey)
+{
+	// 0の場合は制限しない
+	const int64 Budget = (int64)GetDefault<UPDFImporterSettings>()->PageCacheBudgetMB * 1024 * 1024;
+	if (Budget <= 0)
+	{
+		return;
+	}
+
+	while (ResidentBytes > Budget)
+	{
+		// 最も長く使われていないページを探す
+		// 追加したばかりのページと表示中のページは解放しない
+		TPair<const UPDF*, int> VictimKey;
+		FEntry* Victim = nullptr;
+		for (auto& Pair : Entries)
+		{
+			if (Pair.Key == KeepKey)
+			{
+				continue;
+			}
+
+			UPDF* PDF = Pair.Value.PDF.Get();
+			if (PDF != nullptr && PDF->IsPagePinned(Pair.Value.PageIndex + 1))
+			{
+				continue;
+			}
+
+			if (Victim == nullptr || Pair.Value.LastUsed < Victim->LastUsed)
+			{
+				VictimKey = Pair.Key;
+				Victim = &Pair.Value;
+			}
+		}
+
+		if (Victim == nullptr)
+		{
+			UE_LOG(PDFImporter, Warning, TEXT("Page cache exceeds the budget because all resident pages are pinned"));
+			return;
+		}
+
+		// テクスチャへの参照を外してGCで解放させる
+		UPDF* PDF = Victim->PDF.Get();
+		if (PDF != nullptr && PDF->Pages.IsValidIndex(Victim->PageIndex))
+		{
+			PDF->Pages[Victim->PageIndex] = nullptr;
+		}
+
+		ResidentBytes -= Victim->Size;
+		Stats.Evictions++;
+		Entries.Remove(VictimKey);
+	}
+}
@@ -0,0 +1,377 @@
+#include "PDFRenderCache.h"
+#include "PDFImporter.h"
+#include "PDFImporterSettings.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/SecureHash.h"
+#include "Misc/ScopeLock.h"
+#include "Misc/Guid.h"
+#include "Serialization/Archive.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+#include "Misc/Compression.h"
+
+#if WITH_EDITOR
+#include "DerivedDataCacheInterface.h"
+#endif
+
+// キャッシュファイルの識別子と形式のバージョン
+static const uint32 PageFileMagic = 0x50444650;	// "PDFP"
+static const int32 PageFileVersion = 1;
+
+// 派生データキャッシュのキーの識別子と形式のバージョン、形式を変えた場合はバージョンを変更する
+static const TCHAR* DerivedDataPrefix = TEXT("PDFPAGE");
+static const TCHAR* DerivedDataVersion = TEXT("5B1C3A0E8D2F4C6BA9E07F13D24C8B61");
+
+FPDFRenderCache::FPDFRenderCache(const FString& InDirectoryPath)
+	: DirectoryPath(InDirectoryPath)
+	, TotalSize(-1)
+{
+	IFileManager::Get().MakeDirectory(*DirectoryPath, true);
+}
+
+FString FPDFRenderCache::GetContentHash(const FString& InputPath)
+{
+	IFileManager& FileManager = IFileManager::Get();
+	const FDateTime TimeStamp = FileManager.GetTimeStamp(*InputPath);
+	const int64 Size = FileManager.FileSize(*InputPath);
+	if (Size < 0)
+	{
+		return FString();
+	}
+
+	// ファイルが変更されていなければ前回のハッシュを使う
+	{
+		FScopeLock Lock(&CriticalSection);
+		const FContentHash* Cached = ContentHashes.Find(InputPath);
+		if (Cached != nullptr && Cached->TimeStamp == TimeStamp && Cached->Size == Size)
+		{
+			return Cached->Hash;
+		}
+	}
+
+	const FMD5Hash FileHash = FMD5Hash::HashFile(*InputPath);
+	if (!FileHash.IsValid())
+	{
+		return FString();
+	}
+
+	FContentHash NewHash;
+	NewHash.TimeStamp = TimeStamp;
+	NewHash.Size = Size;
+	NewHash.Hash = LexToString(FileHash);
+
+	FScopeLock Lock(&CriticalSection);
+	ContentHashes.Add(InputPath, NewHash);
+	return NewHash.Hash;
+}
+
+FString FPDFRenderCache::MakeDocumentKey(const FString& ContentHash, const FString& RenderOptions)
+{
+	return ContentHash + TEXT("-") + RenderOptions;
+}
+
+bool FPDFRenderCache::LoadPage(const FString& DocumentKey, int PageNumber, FPageBitmap& OutBitmap)
+{
+	const FString FilePath = GetPageFilePath(DocumentKey, PageNumber);
+	TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*FilePath, FILEREAD_Silent));
+	if (!Reader.IsValid())
+	{
+#if WITH_EDITOR
+		// 他のマシンで描画されたページがあればローカルにも書き込んでおく
+		if (LoadPageFromDerivedData(DocumentKey, PageNumber, OutBitmap))
+		{
+			if (WritePageFile(FilePath, OutBitmap))
+			{
+				AddToTotalSize(IFileManager::Get().FileSize(*FilePath));
+			}
+			return true;
+		}
+#endif
+		return false;
+	}
+
+	uint32 Magic = 0;
+	int32 Version = 0;
+	int32 Width = 0;
+	int32 Height = 0;
+	*Reader << Magic << Version << Width << Height;
+
+	// 壊れたファイルや古い形式のファイルは使わない
+	const int64 PixelSize = (int64)Width * Height * 4;
+	if (Reader->IsError() || Magic != PageFileMagic || Version != PageFileVersion || Width <= 0 || Height <= 0 || Reader->TotalSize() - Reader->Tell() != PixelSize)
+	{
+		Reader.Reset();
+		IFileManager::Get().Delete(*FilePath, false, false, true);
+		return false;
+	}
+
+	OutBitmap.Width = Width;
+	OutBitmap.Height = Height;
+	OutBitmap.Pixels.SetNumUninitialized(PixelSize);
+	Reader->Serialize(OutBitmap.Pixels.GetData(), PixelSize);
+	if (!Reader->Close())
+	{
+		return false;
+	}
+
+	// 最近使ったファイルを削除しないように更新日時を変更
+	IFileManager::Get().SetTimeStamp(*FilePath, FDateTime::UtcNow());
+	return true;
+}
+
+bool FPDFRenderCache::HasPage(const FString& DocumentKey, int PageNumber) const
+{
+	if (IFileManager::Get().FileExists(*GetPageFilePath(DocumentKey, PageNumber)))
+	{
+		return true;
+	}
+
+#if WITH_EDITOR
+	if (UseDerivedDataCache())
+	{
+		return GetDerivedDataCacheRef().CachedDataProbablyExists(*GetDerivedDataKey(FString::Printf(TEXT("%s-%d"), *DocumentKey, PageNumber)));
+	}
+#endif
+
+	return false;
+}
+
+void FPDFRenderCache::StorePage(const FString& DocumentKey, int PageNumber, const FPageBitmap& Bitmap)
+{
+#if WITH_EDITOR
+	StorePageToDerivedData(DocumentKey, PageNumber, Bitmap);
+#endif
+
+	const FString FilePath = GetPageFilePath(DocumentKey, PageNumber);
+	if (WritePageFile(FilePath, Bitmap))
+	{
+		AddToTotalSize(IFileManager::Get().FileSize(*FilePath));
+	}
+}
+
+bool FPDFRenderCache::WritePageFile(const FString& FilePath, const FPageBitmap& Bitmap)
+{
+	// 同じページを複数の変換が同時に書き込む場合があるので一時ファイルは書き込みごとに別の名前にする
+	const FString TempFilePath = FString::Printf(TEXT("%s.%s.tmp"), *FilePath, *FGuid::NewGuid().ToString());
+
+	// 書き込み途中のファイルを読まないように別名で書き込んでから移動
+	{
+		TUniquePtr<FArchive> Writer(IFileManager::Get().CreateFileWriter(*TempFilePath, FILEWRITE_Silent));
+		if (!Writer.IsValid())
+		{
+			return false;
+		}
+
+		uint32 Magic = PageFileMagic;
+		int32 Version = PageFileVersion;
+		int32 Width = Bitmap.Width;
+		int32 Height = Bitmap.Height;
+		*Writer << Magic << Version << Width << Height;
+		Writer->Serialize(const_cast<uint8*>(Bitmap.Pixels.GetData()), Bitmap.Pixels.Num());
+		if (!Writer->Close())
+		{
+			Writer.Reset();
+			IFileManager::Get().Delete(*TempFilePath, false, false, true);
+			return false;
+		}
+	}
+
+	if (!IFileManager::Get().Move(*FilePath, *TempFilePath, true, true, false, true))
+	{
+		IFileManager::Get().Delete(*TempFilePath, false, false, true);
+		return false;
+	}
+
+	return true;
+}
+
+int FPDFRenderCache::LoadPageCount(const FString& ContentHash)
+{
+	FString Text;
+	if (FFileHelper::LoadFileToString(Text, *FPaths::Combine(DirectoryPath, ContentHash + TEXT(".pagecount"))))
+	{
+		return FMath::Max(FCString::Atoi(*Text), 0);
+	}
+
+#if WITH_EDITOR
+	TArray<uint8> Data;
+	if (UseDerivedDataCache() && GetDerivedDataCacheRef().GetSynchronous(*GetDerivedDataKey(ContentHash + TEXT("-pagecount")), Data) && Data.Num() == sizeof(int32))
+	{
+		int32 PageCount = 0;
+		FMemoryReader(Data) << PageCount;
+		FFileHelper::SaveStringToFile(FString::FromInt(PageCount), *FPaths::Combine(DirectoryPath, ContentHash + TEXT(".pagecount")));
+		return FMath::Max(PageCount, 0);
+	}
+#endif
+
+	return 0;
+}
+
+void FPDFRenderCache::StorePageCount(const FString& ContentHash, int PageCount)
+{
+	FFileHelper::SaveStringToFile(FString::FromInt(PageCount), *FPaths::Combine(DirectoryPath, ContentHash + TEXT(".pagecount")));
+
+#if WITH_EDITOR
+	if (UseDerivedDataCache())
+	{
+		TArray<uint8> Data;
+		int32 Count = PageCount;
+		FMemoryWriter(Data) << Count;
+		GetDerivedDataCacheRef().Put(*GetDerivedDataKey(ContentHash + TEXT("-pagecount")), Data);
+	}
+#endif
+}
+
+FString FPDFRenderCache::GetPageFilePath(const FString& DocumentKey, int PageNumber) const
+{
+	return FPaths::Combine(DirectoryPath, FString::Printf(TEXT("%s-%d.page"), *DocumentKey, PageNumber));
+}
+
+void FPDFRenderCache::AddToTotalSize(int64 Size)
+{
+	FScopeLock Lock(&CriticalSection);
+
+	IFileManager& FileManager = IFileManager::Get();
+
+	struct FCacheFile
+	{
+		FString Path;
+		FDateTime TimeStamp;
+		int64 Size;
+	};
+
+	// 初回はディレクトリ内のファイルサイズを合計する
+	TArray<FCacheFile> Files;
+	auto ScanFiles = [&]()
+	{
+		Files.Reset();
+		FileManager.IterateDirectoryStat(*DirectoryPath, [&Files](const TCHAR* Path, const FFileStatData& StatData)
+		{
+			if (!StatData.bIsDirectory && FPaths::GetExtension(Path) == TEXT("page"))
+			{
+				Files.Add({ Path, StatData.ModificationTime, StatData.FileSize });
+			}
+			return true;
+		});
+	};
+
+	if (TotalSize < 0)
+	{
+		ScanFiles();
+		TotalSize = 0;
+		for (const FCacheFile& File : Files)
+		{
+			TotalSize += File.Size;
+		}
+	}
+	else
+	{
+		TotalSize += FMath::Max<int64>(Size, 0);
+	}
+
+	const int64 MaxSize = (int64)GetDefault<UPDFImporterSettings>()->RenderCacheSizeMB * 1024 * 1024;
+	if (TotalSize <= MaxSize)
+	{
+		return;
+	}
+
+	// 使われていない順に削除して上限の9割まで減らす
+	if (Files.Num() == 0)
+	{
+		ScanFiles();
+	}
+	Files.Sort([](const FCacheFile& A, const FCacheFile& B) { return A.TimeStamp < B.TimeStamp; });
+
+	const int64 TargetSize = MaxSize / 10 * 9;
+	for (const FCacheFile& File : Files)
+	{
+		if (TotalSize <= TargetSize)
+		{
+			break;
+		}
+
+		if (FileManager.Delete(*File.Path, false, false, true))
+		{
+			TotalSize -= File.Size;
+		}
+	}
+
+	UE_LOG(PDFImporter, Log, TEXT("Render cache trimmed to %lld bytes"), TotalSize);
+}
+
+#if WITH_EDITOR
+bool FPDFRenderCache::UseDerivedDataCache()
+{
+	return GetDefault<UPDFImporterSettings>()->bUseDerivedDataCache;
+}
+
+FString FPDFRenderCache::GetDerivedDataKey(const FString& Key)
+{
+	return FDerivedDataCacheInterface::BuildCacheKey(DerivedDataPrefix, DerivedDataVersion, *Key);
+}
+
+bool FPDFRenderCache::LoadPageFromDerivedData(const FString& DocumentKey, int PageNumber, FPageBitmap& OutBitmap)
+{
+	if (!UseDerivedDataCache())
+	{
+		return false;
+	}
+
+	TArray<uint8> Data;
+	if (!GetDerivedDataCacheRef().GetSynchronous(*GetDerivedDataKey(FString::Printf(TEXT("%s-%d"), *DocumentKey, PageNumber)), Data))
+	{
+		return false;
+	}
+
+	FMemoryReader Reader(Data);
+	uint32 Magic = 0;
+	int32 Version = 0;
+	int32 Width = 0;
+	int32 Height = 0;
+	int32 CompressedSize = 0;
+	Reader << Magic << Version << Width << Height << CompressedSize;
+
+	// 形式が異なるデータや壊れたデータは使わない
+	const int64 PixelSize = (int64)Width * Height * 4;
+	if (Reader.IsError() || Magic != PageFileMagic || Version != PageFileVersion || Width <= 0 || Height <= 0 || PixelSize > MAX_int32
+		|| CompressedSize <= 0 || Data.Num() - Reader.Tell() != CompressedSize)
+	{
+		return false;
+	}
+
+	OutBitmap.Width = Width;
+	OutBitmap.Height = Height;
+	OutBitmap.Pixels.SetNumUninitialized(PixelSize);
+	return FCompression::UncompressMemory(NAME_Zlib, OutBitmap.Pixels.GetData(), (int32)PixelSize, Data.GetData() + Reader.Tell(), CompressedSize);
+}
+
+void FPDFRenderCache::StorePageToDerivedData(const FString& DocumentKey, int PageNumber, const FPageBitmap& Bitmap)
+{
+	if (!UseDerivedDataCache())
+	{
+		return;
+	}
+
+	// ページの大部分は紙の色なので圧縮すると共有キャッシュの転送量が大きく減る
+	int32 CompressedSize = FCompression::CompressMemoryBound(NAME_Zlib, Bitmap.Pixels.Num());
+	TArray<uint8> CompressedPixels;
+	CompressedPixels.SetNumUninitialized(CompressedSize);
+	if (!FCompression::CompressMemory(NAME_Zlib, CompressedPixels.GetData(), CompressedSize, Bitmap.Pixels.GetData(), Bitmap.Pixels.Num()))
+	{
+		return;
+	}
+
+	TArray<uint8> Data;
+	FMemoryWriter Writer(Data);
+	uint32 Magic = PageFileMagic;
+	int32 Version = PageFileVersion;
+	int32 Width = Bitmap.Width;
+	int32 Height = Bitmap.Height;
+	Writer << Magic << Version << Width << Height << CompressedSize;
+	Writer.Serialize(CompressedPixels.GetData(), CompressedSize);
+
+	GetDerivedDataCacheRef().Put(*GetDerivedDataKey(FString::Printf(TEXT("%s-%d"), *DocumentKey, PageNumber)), Data);
+}
+#endif
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GhostscriptCore.h"
+
+// Rendered pages stored on disk so that the same PDF converted with the same settings skips Ghostscript
+// Entries are keyed by the hash of the file contents, so renamed or copied files still hit the cache
+// In the editor, pages are also shared through the derived data cache so that other machines skip Ghostscript too
+class FPDFRenderCache
+{
+private:
+	// Directory where cached pages are stored
+	FString DirectoryPath;
+
+	// Hash of files already read, keyed by path and invalidated by time stamp and size
+	struct FContentHash
+	{
+		FDateTime TimeStamp;
+		int64 Size;
+		FString Hash;
+	};
+	TMap<FString, FContentHash> ContentHashes;
+
+	// Total size of the cached files, -1 until the directory has been scanned
+	int64 TotalSize;
+
+	FCriticalSection CriticalSection;
+
+public:
+	// Constructor
+	FPDFRenderCache(const FString& InDirectoryPath);
+
+	// Get the hash of the file contents, empty if the file cannot be read
+	FString GetContentHash(const FString& InputPath);
+
+	// Make the key shared by all pages of a document rendered with the same options
+	static FString MakeDocumentKey(const FString& ContentHash, const FString& RenderOptions);
+
+	// Read page pixels, returns false if the page is not cached
+	bool LoadPage(const FString& DocumentKey, int PageNumber, FPageBitmap& OutBitmap);
+
+	// Whether the page is cached without reading it
+	bool HasPage(const FString& DocumentKey, int PageNumber) const;
+
+	// Write page pixels and evict old entries if the cache exceeds its size limit
+	void StorePage(const FString& DocumentKey, int PageNumber, const FPageBitmap& Bitmap);
+
+	// Read number of pages, returns 0 if not cached
+	int LoadPageCount(const FString& ContentHash);
+
+	// Write number of pages
+	void StorePageCount(const FString& ContentHash, int PageCount);
+
+private:
+	// Get the path of the file that stores the page
+	FString GetPageFilePath(const FString& DocumentKey, int PageNumber) const;
+
+	// Add the size of a new file and delete least recently used files while over the size limit
+	void AddToTotalSize(int64 Size);
+
+	// Write page pixels to the local cache file
+	bool WritePageFile(const FString& FilePath, const FPageBitmap& Bitmap);
+
+#if WITH_EDITOR
+	// Whether the derived data cache is used in addition to the local cache
+	static bool UseDerivedDataCache();
+
+	// Get the derived data cache key of a page or of the page count
+	static FString GetDerivedDataKey(const FString& Key);
+
+	// Read page pixels from the derived data cache, returns false if the page is not cached
+	bool LoadPageFromDerivedData(const FString& DocumentKey, int PageNumber, FPageBitmap& OutBitmap);
+
+	// Write compressed page pixels to the derived data cache
+	void StorePageToDerivedData(const FString& DocumentKey, int PageNumber, const FPageBitmap& Bitmap);
+#endif
+};
@@ -0,0 +1,111 @@
+#include "PageBitmapQueue.h"
+#include "HAL/Event.h"
+#include "HAL/PlatformProcess.h"
+#include "Misc/ScopeLock.h"
+
+FPageBitmapQueue::FPageBitmapQueue(int FirstPage, int InCapacity)
+	: NextPage(FirstPage)
+	, Capacity(FMath::Max(InCapacity, 1))
+	, bIsClosed(false)
+	, bIsAborted(false)
+{
+	// 待機側がロック中にリセットするので手動リセットのイベントを使う
+	PageAddedEvent = FPlatformProcess::GetSynchEventFromPool(true);
+	PageRemovedEvent = FPlatformProcess::GetSynchEventFromPool(true);
+}
+
+FPageBitmapQueue::~FPageBitmapQueue()
+{
+	FPlatformProcess::ReturnSynchEventToPool(PageAddedEvent);
+	FPlatformProcess::ReturnSynchEventToPool(PageRemovedEvent);
+}
+
+bool FPageBitmapQueue::Push(int PageNumber, FPageBitmap& Bitmap)
+{
+	while (true)
+	{
+		{
+			FScopeLock Lock(&CriticalSection);
+
+			if (bIsAborted)
+			{
+				return false;
+			}
+
+			// 消費側に近いページだけを保持してメモリの使用量を一定に保つ
+			if (PageNumber < NextPage + Capacity)
+			{
+				PendingPages.Add(PageNumber, MoveTemp(Bitmap));
+				PageAddedEvent->Trigger();
+				return true;
+			}
+
+			PageRemovedEvent->Reset();
+		}
+
+		PageRemovedEvent->Wait();
+	}
+}
+
+bool FPageBitmapQueue::Pop(int& OutPageNumber, FPageBitmap& OutBitmap)
+{
+	while (true)
+	{
+		{
+			FScopeLock Lock(&CriticalSection);
+
+			if (bIsAborted)
+			{
+				return false;
+			}
+
+			FPageBitmap* Bitmap = PendingPages.Find(NextPage);
+			if (Bitmap != nullptr)
+			{
+				OutBitmap = MoveTemp(*Bitmap);
+				PendingPages.Remove(NextPage);
+				OutPageNumber = NextPage++;
+				PageRemovedEvent->Trigger();
+				return true;
+			}
+
+			// 全てのワーカーが終了していればこれ以上ページは来ない
+			if (bIsClosed)
+			{
+				return false;
+			}
+
+			PageAddedEvent->Reset();
+		}
+
+		PageAddedEvent->Wait();
+	}
+}
+
+void FPageBitmapQueue::Close()
+{
+	FScopeLock Lock(&CriticalSection);
+	bIsClosed = true;
+	PageAddedEvent->Trigger();
+}
+
+void FPageBitmapQueue::Abort()
+{
+	FScopeLock Lock(&CriticalSection);
+	bIsAborted = true;
+	PendingPages.Empty();
+	PageAddedEvent->Trigger();
+	PageRemovedEvent->Trigger();
+}
+
+int FPageBitmapQueue::GetNextPage()
+{
+	FScopeLock Lock(&CriticalSection);
+	return NextPage;
+}
+
+bool FPageBitmapQueue::IsAborted()
+{
+	FScopeLock Lock(&CriticalSection);
+	return bIsAborted;
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GhostscriptCore.h"
+
+// Bounded queue that hands rendered pages from the render workers to a single consumer in page order
+class FPageBitmapQueue
+{
+private:
+	// Pages that have been rendered but not yet taken by the consumer
+	TMap<int, FPageBitmap> PendingPages;
+
+	// The page the consumer is waiting for
+	int NextPage;
+
+	// Pages at or beyond NextPage + Capacity have to wait
+	int Capacity;
+
+	bool bIsClosed;
+	bool bIsAborted;
+
+	FCriticalSection CriticalSection;
+	FEvent* PageAddedEvent;
+	FEvent* PageRemovedEvent;
+
+public:
+	// Constructor
+	FPageBitmapQueue(int FirstPage, int InCapacity);
+
+	// Destructor
+	~FPageBitmapQueue();
+
+	// Add rendered page, blocks while the page is too far ahead of the consumer
+	// Returns false if the queue has been aborted
+	bool Push(int PageNumber, FPageBitmap& Bitmap);
+
+	// Take the next page in order, blocks until it is rendered
+	// Returns false if the page will never arrive
+	bool Pop(int& OutPageNumber, FPageBitmap& OutBitmap);
+
+	// Notify that no more pages will be added
+	void Close();
+
+	// Release all waiting threads and discard pending pages
+	void Abort();
+
+	// Get the page the consumer is waiting for
+	int GetNextPage();
+
+	bool IsAborted();
+};
@@ -0,0 +1,347 @@
+#include "PageTextureEncoder.h"
+#include "Async/ParallelFor.h"
+
+// BC1のブロックは4x4ピクセル
+static const int BlockSize = 4;
+static const int BC1BytesPerBlock = 8;
+
+void FPageTextureEncoder::Encode(const FPageBitmap& Bitmap, EPDFPageCompression Compression, FPageTextureData& OutData)
+{
+	OutData.Mips.Reset();
+
+	if (Compression == EPDFPageCompression::Uncompressed)
+	{
+		OutData.Width = Bitmap.Width;
+		OutData.Height = Bitmap.Height;
+		OutData.Format = PF_B8G8R8A8;
+		OutData.Mips.Add(Bitmap.Pixels);
+		return;
+	}
+
+	// 圧縮テクスチャの最上位のミップは4の倍数の大きさでなければならないので端のピクセルを複製して広げる
+	int Width = Align(Bitmap.Width, BlockSize);
+	int Height = Align(Bitmap.Height, BlockSize);
+	TArray<uint8> Pixels;
+	Pixels.SetNumUninitialized(Width * Height * 4);
+	for (int Y = 0; Y < Height; Y++)
+	{
+		const uint8* SourceRow = Bitmap.Pixels.GetData() + FMath::Min(Y, Bitmap.Height - 1) * Bitmap.Width * 4;
+		uint8* DestRow = Pixels.GetData() + Y * Width * 4;
+		FMemory::Memcpy(DestRow, SourceRow, Bitmap.Width * 4);
+		for (int X = Bitmap.Width; X < Width; X++)
+		{
+			FMemory::Memcpy(DestRow + X * 4, SourceRow + (Bitmap.Width - 1) * 4, 4);
+		}
+	}
+
+	OutData.Width = Width;
+	OutData.Height = Height;
+	OutData.Format = PF_DXT1;
+
+	// 1x1になるまでミップを作成して圧縮する
+	while (true)
+	{
+		CompressBC1(Pixels, Width, Height, OutData.Mips.AddDefaulted_GetRef());
+		if (Width == 1 && Height == 1)
+		{
+			break;
+		}
+
+		TArray<uint8> MipPixels;
+		Downsample(Pixels, Width, Height, MipPixels, Width, Height);
+		Pixels = MoveTemp(MipPixels);
+	}
+}
+
+void FPageTextureEncoder::Downsample(const TArray<uint8>& Source, int SourceWidth, int SourceHeight, TArray<uint8>& OutPixels, int& OutWidth, int& OutHeight)
+{
+	const int Width = FMath::Max(SourceWidth / 2, 1);
+	const int Height = FMath::Max(SourceHeight / 2, 1);
+	OutPixels.SetNumUninitialized(Width * Height * 4);
+
+	ParallelFor(Height, [&](int Y)
+	{
+		const int Y0 = FMath::Min(Y * 2, SourceHeight - 1);
+		const int Y1 = FMath::Min(Y * 2 + 1, SourceHeight - 1);
+		for (int X = 0; X < Width; X++)
+		{
+			const int X0 = FMath::Min(X * 2, SourceWidth - 1);
+			const int X1 = FMath::Min(X * 2 + 1, SourceWidth - 1);
+			for (int Channel = 0; Channel < 4; Channel++)
+			{
+				const int Sum =
+					Source[(Y0 * SourceWidth + X0) * 4 + Channel] + Source[(Y0 * SourceWidth + X1) * 4 + Channel] +
+					Source[(Y1 * SourceWidth + X0) * 4 + Channel] + Source[(Y1 * SourceWidth + X1) * 4 + Channel];
+				OutPixels[(Y * Width + X) * 4 + Channel] = (uint8)((Sum + 2) / 4);
+			}
+		}
+	});
+
+	OutWidth = Width;
+	OutHeight = Height;
+}
+
+void FPageTextureEncoder::CompressBC1(const TArray<uint8>& Pixels, int Width, int Height, TArray<uint8>& OutBlocks)
+{
+	const int BlocksX = FMath::DivideAndRoundUp(Width, BlockSize);
+	const int BlocksY = FMath::DivideAndRoundUp(Height, BlockSize);
+	OutBlocks.SetNumUninitialized(BlocksX * BlocksY * BC1BytesPerBlock);
+
+	// ブロックの行ごとに別のスレッドで圧縮する
+	ParallelFor(BlocksY, [&](int BlockY)
+	{
+		uint8 Block[16][4];
+		for (int BlockX = 0; BlockX < BlocksX; BlockX++)
+		{
+			// 小さいミップは4x4に満たないので端のピクセルを繰り返す
+			for (int Index = 0; Index < 16; Index++)
+			{
+				const int X = FMath::Min(BlockX * BlockSize + Index % BlockSize, Width - 1);
+				const int Y = FMath::Min(BlockY * BlockSize + Index / BlockSize, Height - 1);
+				FMemory::Memcpy(Block[Index], Pixels.GetData() + (Y * Width + X) * 4, 4);
+			}
+
+			CompressBC1Block(Block, OutBlocks.GetData() + (BlockY * BlocksX + BlockX) * BC1BytesPerBlock);
+		}
+	});
+}
+
+void FPageTextureEncoder::CompressBC1Block(const uint8 Block[16][4], uint8* OutBlock)
+{
+	// 色の分布の主軸の両端を代表色にする
+	// 軸に沿わない色が混ざるブロックでも文字や線の色が黒と紫の中間色にならない
+	uint8 Endpoint0[3];
+	uint8 Endpoint1[3];
+	FindBC1Endpoints(Block, Endpoint0, Endpoint1);
+
+	uint16 Color0;
+	uint16 Color1;
+	uint32 Indices;
+	int Error = EncodeBC1Block(Block, Endpoint0, Endpoint1, Color0, Color1, Indices);
+
+	// 選ばれたインデックスに合わせて代表色を最小二乗法で調整し、誤差が減る場合だけ使う
+	if (Error > 0 && RefineBC1Endpoints(Block, Indices, Endpoint0, Endpoint1))
+	{
+		uint16 RefinedColor0;
+		uint16 RefinedColor1;
+		uint32 RefinedIndices;
+		const int RefinedError = EncodeBC1Block(Block, Endpoint0, Endpoint1, RefinedColor0, RefinedColor1, RefinedIndices);
+		if (RefinedError < Error)
+		{
+			Color0 = RefinedColor0;
+			Color1 = RefinedColor1;
+			Indices = RefinedIndices;
+		}
+	}
+
+	// リトルエンディアンで書き込む
+	OutBlock[0] = (uint8)(Color0 & 0xFF);
+	OutBlock[1] = (uint8)(Color0 >> 8);
+	OutBlock[2] = (uint8)(Color1 & 0xFF);
+	OutBlock[3] = (uint8)(Color1 >> 8);
+	OutBlock[4] = (uint8)(Indices & 0xFF);
+	OutBlock[5] = (uint8)((Indices >> 8) & 0xFF);
+	OutBlock[6] = (uint8)((Indices >> 16) & 0xFF);
+	OutBlock[7] = (uint8)(Indices >> 24);
+}
+
+void FPageTextureEncoder::FindBC1Endpoints(const uint8 Block[16][4], uint8 OutColor0[3], uint8 OutColor1[3])
+{
+	// 平均と共分散を求める
+	float Mean[3] = { 0.0f, 0.0f, 0.0f };
+	for (int Index = 0; Index < 16; Index++)
+	{
+		for (int Channel = 0; Channel < 3; Channel++)
+		{
+			Mean[Channel] += Block[Index][Channel] / 16.0f;
+		}
+	}
+
+	float Covariance[3][3] = {};
+	for (int Index = 0; Index < 16; Index++)
+	{
+		float Difference[3];
+		for (int Channel = 0; Channel < 3; Channel++)
+		{
+			Difference[Channel] = Block[Index][Channel] - Mean[Channel];
+		}
+		for (int Row = 0; Row < 3; Row++)
+		{
+			for (int Column = 0; Column < 3; Column++)
+			{
+				Covariance[Row][Column] += Difference[Row] * Difference[Column];
+			}
+		}
+	}
+
+	// 分散が最も大きいチャンネルの列から始めて累乗法で主軸を求める
+	// 範囲の対角線から始めると赤と青のように逆向きに変化する色で軸が消えてしまう
+	int StartChannel = 0;
+	for (int Channel = 1; Channel < 3; Channel++)
+	{
+		if (Covariance[Channel][Channel] > Covariance[StartChannel][StartChannel])
+		{
+			StartChannel = Channel;
+		}
+	}
+
+	float Axis[3] = { Covariance[0][StartChannel], Covariance[1][StartChannel], Covariance[2][StartChannel] };
+	for (int Iteration = 0; Iteration < 4; Iteration++)
+	{
+		float NewAxis[3];
+		for (int Row = 0; Row < 3; Row++)
+		{
+			NewAxis[Row] = Covariance[Row][0] * Axis[0] + Covariance[Row][1] * Axis[1] + Covariance[Row][2] * Axis[2];
+		}
+
+		const float Length = FMath::Max3(FMath::Abs(NewAxis[0]), FMath::Abs(NewAxis[1]), FMath::Abs(NewAxis[2]));
+		if (Length < KINDA_SMALL_NUMBER)
+		{
+			break;
+		}
+		for (int Channel = 0; Channel < 3; Channel++)
+		{
+			Axis[Channel] = NewAxis[Channel] / Length;
+		}
+	}
+
+	// 単色のブロックでは軸が求まらないので輝度の軸を使う
+	if (FMath::Abs(Axis[0]) + FMath::Abs(Axis[1]) + FMath::Abs(Axis[2]) < KINDA_SMALL_NUMBER)
+	{
+		Axis[0] = 0.114f;
+		Axis[1] = 0.587f;
+		Axis[2] = 0.299f;
+	}
+
+	// 軸に投影した位置が両端のピクセルを代表色にする
+	int MinIndex = 0;
+	int MaxIndex = 0;
+	float MinDot = MAX_flt;
+	float MaxDot = -MAX_flt;
+	for (int Index = 0; Index < 16; Index++)
+	{
+		const float Dot = Block[Index][0] * Axis[0] + Block[Index][1] * Axis[1] + Block[Index][2] * Axis[2];
+		if (Dot < MinDot)
+		{
+			MinDot = Dot;
+			MinIndex = Index;
+		}
+		if (Dot > MaxDot)
+		{
+			MaxDot = Dot;
+			MaxIndex = Index;
+		}
+	}
+
+	FMemory::Memcpy(OutColor0, Block[MaxIndex], 3);
+	FMemory::Memcpy(OutColor1, Block[MinIndex], 3);
+}
+
+bool FPageTextureEncoder::RefineBC1Endpoints(const uint8 Block[16][4], uint32 Indices, uint8 OutColor0[3], uint8 OutColor1[3])
+{
+	// インデックスごとのColor0の重み、Color1の重みは1から引いたもの
+	static const float Weights[4] = { 1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f };
+
+	float WeightSquared0 = 0.0f;
+	float WeightSquared1 = 0.0f;
+	float WeightProduct = 0.0f;
+	float Weighted0[3] = { 0.0f, 0.0f, 0.0f };
+	float Weighted1[3] = { 0.0f, 0.0f, 0.0f };
+	for (int Index = 0; Index < 16; Index++)
+	{
+		const float Weight0 = Weights[(Indices >> (Index * 2)) & 0x3];
+		const float Weight1 = 1.0f - Weight0;
+		WeightSquared0 += Weight0 * Weight0;
+		WeightSquared1 += Weight1 * Weight1;
+		WeightProduct += Weight0 * Weight1;
+		for (int Channel = 0; Channel < 3; Channel++)
+		{
+			Weighted0[Channel] += Weight0 * Block[Index][Channel];
+			Weighted1[Channel] += Weight1 * Block[Index][Channel];
+		}
+	}
+
+	// 全てのピクセルが同じインデックスの場合は解けない
+	const float Determinant = WeightSquared0 * WeightSquared1 - WeightProduct * WeightProduct;
+	if (FMath::Abs(Determinant) < KINDA_SMALL_NUMBER)
+	{
+		return false;
+	}
+
+	for (int Channel = 0; Channel < 3; Channel++)
+	{
+		const float Color0 = (Weighted0[Channel] * WeightSquared1 - Weighted1[Channel] * WeightProduct) / Determinant;
+		const float Color1 = (Weighted1[Channel] * WeightSquared0 - Weighted0[Channel] * WeightProduct) / Determinant;
+		OutColor0[Channel] = (uint8)FMath::Clamp(FMath::RoundToInt(Color0), 0, 255);
+		OutColor1[Channel] = (uint8)FMath::Clamp(FMath::RoundToInt(Color1), 0, 255);
+	}
+
+	return true;
+}
+
+int FPageTextureEncoder::EncodeBC1Block(const uint8 Block[16][4], const uint8 Endpoint0[3], const uint8 Endpoint1[3], uint16& OutColor0, uint16& OutColor1, uint32& OutIndices)
+{
+	// B,G,Rの順に並んでいるのでRGB565に変換
+	auto ToRGB565 = [](const uint8 Color[3]) -> uint16
+	{
+		return (uint16)(((Color[2] >> 3) << 11) | ((Color[1] >> 2) << 5) | (Color[0] >> 3));
+	};
+	uint16 Color0 = ToRGB565(Endpoint0);
+	uint16 Color1 = ToRGB565(Endpoint1);
+
+	// Color0 > Color1の場合に4色モードになる
+	if (Color0 < Color1)
+	{
+		Swap(Color0, Color1);
+	}
+
+	// 復号した時と同じ色で最も近いものを選ぶ
+	int Palette[4][3];
+	const uint16 Endpoints[2] = { Color0, Color1 };
+	for (int Endpoint = 0; Endpoint < 2; Endpoint++)
+	{
+		const uint16 Color = Endpoints[Endpoint];
+		Palette[Endpoint][0] = ((Color & 0x1F) << 3) | ((Color & 0x1F) >> 2);
+		Palette[Endpoint][1] = (((Color >> 5) & 0x3F) << 2) | (((Color >> 5) & 0x3F) >> 4);
+		Palette[Endpoint][2] = ((Color >> 11) << 3) | ((Color >> 11) >> 2);
+	}
+	for (int Channel = 0; Channel < 3; Channel++)
+	{
+		Palette[2][Channel] = (2 * Palette[0][Channel] + Palette[1][Channel]) / 3;
+		Palette[3][Channel] = (Palette[0][Channel] + 2 * Palette[1][Channel]) / 3;
+	}
+
+	// 代表色が同じ場合は全てのピクセルがColor0になる
+	const int NumPaletteEntries = (Color0 != Color1) ? 4 : 1;
+
+	uint32 Indices = 0;
+	int Error = 0;
+	for (int Index = 0; Index < 16; Index++)
+	{
+		int BestIndex = 0;
+		int BestDistance = MAX_int32;
+		for (int PaletteIndex = 0; PaletteIndex < NumPaletteEntries; PaletteIndex++)
+		{
+			int Distance = 0;
+			for (int Channel = 0; Channel < 3; Channel++)
+			{
+				const int Difference = Block[Index][Channel] - Palette[PaletteIndex][Channel];
+				Distance += Difference * Difference;
+			}
+
+			if (Distance < BestDistance)
+			{
+				BestIndex = PaletteIndex;
+				BestDistance = Distance;
+			}
+		}
+
+		Indices |= (uint32)BestIndex << (Index * 2);
+		Error += BestDistance;
+	}
+
+	OutColor0 = Color0;
+	OutColor1 = Color1;
+	OutIndices = Indices;
+	return Error;
+}
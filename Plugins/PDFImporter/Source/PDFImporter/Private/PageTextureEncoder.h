@@ -0,0 +1,47 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GhostscriptCore.h"
+#include "PDF.h"
+
+// Pixel data of a page texture ready to be copied into a transient texture
+struct FPageTextureData
+{
+	FPageTextureData() : Width(0), Height(0), Format(PF_B8G8R8A8) {}
+
+	int Width;
+	int Height;
+	EPixelFormat Format;
+
+	// Data of each mip, largest first
+	TArray<TArray<uint8>> Mips;
+};
+
+// Converts rendered pages into the format of runtime page textures
+// Thread safe, so that pages can be encoded on the threads that render them
+class FPageTextureEncoder
+{
+public:
+	// Build the mip chain and compress it as specified
+	// BC7 needs the texture compressor of the editor, so it is encoded as BC1 at runtime
+	static void Encode(const FPageBitmap& Bitmap, EPDFPageCompression Compression, FPageTextureData& OutData);
+
+private:
+	// Halve the size of a BGRA8 image with a box filter
+	static void Downsample(const TArray<uint8>& Source, int SourceWidth, int SourceHeight, TArray<uint8>& OutPixels, int& OutWidth, int& OutHeight);
+
+	// Compress a BGRA8 image to BC1 blocks
+	static void CompressBC1(const TArray<uint8>& Pixels, int Width, int Height, TArray<uint8>& OutBlocks);
+
+	// Compress a 4x4 block of BGRA8 pixels to 8 bytes of BC1
+	static void CompressBC1Block(const uint8 Block[16][4], uint8* OutBlock);
+
+	// Pick the two pixels at the ends of the principal axis of the block colors as endpoints
+	static void FindBC1Endpoints(const uint8 Block[16][4], uint8 OutColor0[3], uint8 OutColor1[3]);
+
+	// Fit the endpoints to the palette indices chosen for them by least squares, returns false if they cannot be solved
+	static bool RefineBC1Endpoints(const uint8 Block[16][4], uint32 Indices, uint8 OutColor0[3], uint8 OutColor1[3]);
+
+	// Quantize the endpoints and choose the nearest palette entry of each pixel, returns the squared error of the block
+	static int EncodeBC1Block(const uint8 Block[16][4], const uint8 Endpoint0[3], const uint8 Endpoint1[3], uint16& OutColor0, uint16& OutColor1, uint32& OutIndices);
+};
@@ -0,0 +1,174 @@
+#include "PageTextureUploader.h"
+#include "PageTextureEncoder.h"
+#include "GhostscriptCore.h"
+#include "PDFImporter.h"
+#include "PDFImporterSettings.h"
+#include "Engine/Texture2D.h"
+#include "HAL/Event.h"
+
+FPageTextureUploadBatch::FPageTextureUploadBatch()
+	: NumPending(0), bIsReleased(false)
+{
+	// 手動でリセットし、待つ前に完了していても取りこぼさないようにする
+	CompletedEvent = FPlatformProcess::GetSynchEventFromPool(true);
+	CompletedEvent->Trigger();
+}
+
+FPageTextureUploadBatch::~FPageTextureUploadBatch()
+{
+	FPlatformProcess::ReturnSynchEventToPool(CompletedEvent);
+}
+
+FPageTextureUploader::FPageTextureUploader()
+{
+	TickerHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FPageTextureUploader::Tick));
+}
+
+FPageTextureUploader::~FPageTextureUploader()
+{
+	FTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+
+	// 待っているワーカーが止まったままにならないように作成済みのテクスチャだけで完了させる
+	FScopeLock Lock(&BatchesCriticalSection);
+	for (const TSharedPtr<FPageTextureUploadBatch, ESPMode::ThreadSafe>& Batch : Batches)
+	{
+		FScopeLock BatchLock(&Batch->CriticalSection);
+		Batch->NumPending = 0;
+		Batch->CompletedEvent->Trigger();
+	}
+}
+
+TSharedRef<FPageTextureUploadBatch, ESPMode::ThreadSafe> FPageTextureUploader::CreateBatch()
+{
+	TSharedRef<FPageTextureUploadBatch, ESPMode::ThreadSafe> Batch = MakeShared<FPageTextureUploadBatch, ESPMode::ThreadSafe>();
+	FScopeLock Lock(&BatchesCriticalSection);
+	Batches.Add(Batch);
+	return Batch;
+}
+
+void FPageTextureUploader::Enqueue(const TSharedRef<FPageTextureUploadBatch, ESPMode::ThreadSafe>& Batch, int PageIndex, const TSharedRef<FPageTextureData, ESPMode::ThreadSafe>& TextureData)
+{
+	{
+		FScopeLock Lock(&Batch->CriticalSection);
+		if (Batch->Textures.Num() <= PageIndex)
+		{
+			Batch->Textures.SetNumZeroed(PageIndex + 1);
+		}
+		Batch->NumPending++;
+		Batch->CompletedEvent->Reset();
+	}
+
+	FRequest Request;
+	Request.TextureData = TextureData;
+	Request.Batch = Batch;
+	Request.PageIndex = PageIndex;
+	Requests.Enqueue(MoveTemp(Request));
+}
+
+void FPageTextureUploader::Enqueue(const TSharedRef<FPageTextureData, ESPMode::ThreadSafe>& TextureData, TFunction<void(UTexture2D*)> OnCreated)
+{
+	FRequest Request;
+	Request.TextureData = TextureData;
+	Request.PageIndex = INDEX_NONE;
+	Request.OnCreated = MoveTemp(OnCreated);
+	Requests.Enqueue(MoveTemp(Request));
+}
+
+void FPageTextureUploader::WaitForBatch(const TSharedRef<FPageTextureUploadBatch, ESPMode::ThreadSafe>& Batch, TArray<UTexture2D*>& OutTextures)
+{
+	check(!IsInGameThread());
+
+	Batch->CompletedEvent->Wait();
+
+	// 作成に失敗したページは除く
+	FScopeLock Lock(&Batch->CriticalSection);
+	OutTextures.Reset(Batch->Textures.Num());
+	for (UTexture2D* Texture : Batch->Textures)
+	{
+		if (Texture != nullptr)
+		{
+			OutTextures.Add(Texture);
+		}
+	}
+}
+
+void FPageTextureUploader::ReleaseBatch(const TSharedRef<FPageTextureUploadBatch, ESPMode::ThreadSafe>& Batch)
+{
+	{
+		FScopeLock Lock(&Batch->CriticalSection);
+		Batch->bIsReleased = true;
+	}
+
+	FScopeLock Lock(&BatchesCriticalSection);
+	Batches.Remove(Batch);
+}
+
+void FPageTextureUploader::AddReferencedObjects(FReferenceCollector& Collector)
+{
+	FScopeLock Lock(&BatchesCriticalSection);
+	for (const TSharedPtr<FPageTextureUploadBatch, ESPMode::ThreadSafe>& Batch : Batches)
+	{
+		FScopeLock BatchLock(&Batch->CriticalSection);
+		Collector.AddReferencedObjects(Batch->Textures);
+	}
+}
+
+bool FPageTextureUploader::Tick(float DeltaTime)
+{
+	const double Budget = GetDefault<UPDFImporterSettings>()->TextureCreationBudgetMs / 1000.0;
+	const double StartTime = FPlatformTime::Seconds();
+
+	FPDFImporterModule& PDFImporterModule = FModuleManager::GetModuleChecked<FPDFImporterModule>(FName("PDFImporter"));
+	TSharedPtr<FGhostscriptCore> GhostscriptCore = PDFImporterModule.GetGhostscriptCore();
+
+	// 予算を超えるまで作成するが、予算が小さくても毎フレーム1枚は進める
+	FRequest Request;
+	while (Requests.Dequeue(Request))
+	{
+		bool bIsReleased = false;
+		if (Request.Batch.IsValid())
+		{
+			FScopeLock Lock(&Request.Batch->CriticalSection);
+			bIsReleased = Request.Batch->bIsReleased;
+		}
+
+		// 不要になった変換のテクスチャは作成しない
+		UTexture2D* Texture = nullptr;
+		if (!bIsReleased && GhostscriptCore.IsValid())
+		{
+			// ピクセルデータはミップのバルクデータに渡し、RHIリソースの作成と転送はレンダースレッドで行われる
+			if (!GhostscriptCore->LoadTexture2DFromTextureData(*Request.TextureData, Texture))
+			{
+				Texture = nullptr;
+			}
+		}
+		Request.TextureData.Reset();
+
+		if (Request.Batch.IsValid())
+		{
+			CompleteBatchRequest(Request, Texture);
+		}
+		else if (Request.OnCreated)
+		{
+			Request.OnCreated(Texture);
+		}
+
+		if (FPlatformTime::Seconds() - StartTime >= Budget)
+		{
+			break;
+		}
+	}
+
+	return true;
+}
+
+void FPageTextureUploader::CompleteBatchRequest(const FRequest& Request, UTexture2D* Texture)
+{
+	FScopeLock Lock(&Request.Batch->CriticalSection);
+	Request.Batch->Textures[Request.PageIndex] = Texture;
+	Request.Batch->NumPending--;
+	if (Request.Batch->NumPending <= 0)
+	{
+		Request.Batch->CompletedEvent->Trigger();
+	}
+}
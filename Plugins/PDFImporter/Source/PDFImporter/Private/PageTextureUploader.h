@@ -0,0 +1,87 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Queue.h"
+#include "Containers/Ticker.h"
+#include "UObject/GCObject.h"
+
+struct FPageTextureData;
+class UTexture2D;
+
+// Textures created for one conversion, referenced by the uploader until the conversion releases them
+struct FPageTextureUploadBatch
+{
+	FPageTextureUploadBatch();
+	~FPageTextureUploadBatch();
+
+	FCriticalSection CriticalSection;
+
+	// Created textures by page index, nullptr while waiting or if creation failed
+	TArray<UTexture2D*> Textures;
+
+	// Number of pages enqueued and not created yet
+	int NumPending;
+
+	// Whether the conversion no longer needs the textures
+	bool bIsReleased;
+
+	// Triggered whenever NumPending reaches 0
+	FEvent* CompletedEvent;
+};
+
+// Creates runtime page textures on the game thread from data encoded on worker threads
+// Only as many textures as fit in the time budget of the project settings are created per frame,
+// so that converting a long document in the background does not stall the game
+class FPageTextureUploader : public FGCObject
+{
+private:
+	struct FRequest
+	{
+		TSharedPtr<FPageTextureData, ESPMode::ThreadSafe> TextureData;
+
+		// Either the batch and page index of a conversion, or a callback
+		TSharedPtr<FPageTextureUploadBatch, ESPMode::ThreadSafe> Batch;
+		int PageIndex;
+		TFunction<void(UTexture2D*)> OnCreated;
+	};
+
+	// Requests from any thread, consumed on the game thread
+	TQueue<FRequest, EQueueMode::Mpsc> Requests;
+
+	// Batches whose textures must not be collected
+	TArray<TSharedPtr<FPageTextureUploadBatch, ESPMode::ThreadSafe>> Batches;
+	FCriticalSection BatchesCriticalSection;
+
+	FDelegateHandle TickerHandle;
+
+public:
+	// Constructor
+	FPageTextureUploader();
+	~FPageTextureUploader();
+
+	// Start a batch of textures for a conversion running on a worker thread
+	TSharedRef<FPageTextureUploadBatch, ESPMode::ThreadSafe> CreateBatch();
+
+	// Queue a page texture of a batch, callable from any thread
+	void Enqueue(const TSharedRef<FPageTextureUploadBatch, ESPMode::ThreadSafe>& Batch, int PageIndex, const TSharedRef<FPageTextureData, ESPMode::ThreadSafe>& TextureData);
+
+	// Queue a page texture and receive it on the game thread, nullptr if creation failed
+	void Enqueue(const TSharedRef<FPageTextureData, ESPMode::ThreadSafe>& TextureData, TFunction<void(UTexture2D*)> OnCreated);
+
+	// Block until all enqueued textures of the batch are created and get them in page order
+	// Must not be called on the game thread, which creates the textures
+	void WaitForBatch(const TSharedRef<FPageTextureUploadBatch, ESPMode::ThreadSafe>& Batch, TArray<UTexture2D*>& OutTextures);
+
+	// Stop referencing the textures of the batch and skip its remaining requests
+	void ReleaseBatch(const TSharedRef<FPageTextureUploadBatch, ESPMode::ThreadSafe>& Batch);
+
+	// FGCObject interface
+	virtual void AddReferencedObjects(FReferenceCollector& Collector) override;
+
+private:
+	// Create the queued textures that fit in the budget of this frame
+	bool Tick(float DeltaTime);
+
+	// Finish a request of a batch on the game thread
+	void CompleteBatchRequest(const FRequest& Request, UTexture2D* Texture);
+};
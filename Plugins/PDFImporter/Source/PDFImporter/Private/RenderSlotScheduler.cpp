@@ -0,0 +1,45 @@
+#include "RenderSlotScheduler.h"
+#include "HAL/Event.h"
+
+FRenderSlotScheduler::FRenderSlotScheduler(int NumSlots)
+	: NumFreeSlots(FMath::Max(NumSlots, 1))
+{
+}
+
+void FRenderSlotScheduler::Acquire()
+{
+	FEvent* Event = nullptr;
+	{
+		FScopeLock Lock(&CriticalSection);
+
+		// 待っているスレッドがいれば追い越さない
+		if (NumFreeSlots > 0 && Waiters.Num() == 0)
+		{
+			NumFreeSlots--;
+			return;
+		}
+
+		Event = FPlatformProcess::GetSynchEventFromPool();
+		Waiters.Add(Event);
+	}
+
+	// Releaseで空きが直接渡される
+	Event->Wait();
+	FPlatformProcess::ReturnSynchEventToPool(Event);
+}
+
+void FRenderSlotScheduler::Release()
+{
+	FScopeLock Lock(&CriticalSection);
+
+	// 空きを戻さずに最も長く待っているスレッドに渡す
+	if (Waiters.Num() > 0)
+	{
+		FEvent* Event = Waiters[0];
+		Waiters.RemoveAt(0);
+		Event->Trigger();
+		return;
+	}
+
+	NumFreeSlots++;
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Limits the number of Ghostscript instances running at the same time across all conversions
+// Slots are handed out in the order they were requested, so that concurrent conversions take turns page chunk by page chunk
+class FRenderSlotScheduler
+{
+private:
+	// Number of slots not held by anyone
+	int NumFreeSlots;
+
+	// Threads waiting for a slot, oldest first
+	TArray<FEvent*> Waiters;
+
+	FCriticalSection CriticalSection;
+
+public:
+	// Constructor
+	FRenderSlotScheduler(int NumSlots);
+
+	// Block until a slot is free and take it
+	void Acquire();
+
+	// Give the slot back to the oldest waiting thread
+	void Release();
+};
+
+// Holds a render slot while in scope
+class FScopedRenderSlot
+{
+private:
+	FRenderSlotScheduler& Scheduler;
+
+public:
+	FScopedRenderSlot(FRenderSlotScheduler& InScheduler) : Scheduler(InScheduler) { Scheduler.Acquire(); }
+	~FScopedRenderSlot() { Scheduler.Release(); }
+};
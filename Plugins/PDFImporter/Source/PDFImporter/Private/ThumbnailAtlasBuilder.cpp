@@ -0,0 +1,94 @@
+#include "ThumbnailAtlasBuilder.h"
+
+// ページ一覧で表示する大きさまで縮小したミップの数
+static const int ThumbnailSampledMips = 2;
+
+// 表示するミップでBC1のブロックが隣のページにまたがらないように配置する位置を揃える
+static const int ThumbnailAlignment = 4 << ThumbnailSampledMips;
+
+// 表示するミップのバイリニア補間で隣のページの色が混ざらないように空ける
+static const int ThumbnailPadding = 1 << ThumbnailSampledMips;
+
+FThumbnailAtlasBuilder::FThumbnailAtlasBuilder(int InAtlasSize)
+	: AtlasSize(InAtlasSize), CursorX(0), CursorY(0), RowHeight(0)
+{
+}
+
+void FThumbnailAtlasBuilder::Add(const FPageBitmap& Thumbnail)
+{
+	// アトラスより大きいページは縦横比を保ったまま縮小
+	FPageBitmap Resized;
+	const FPageBitmap* Source = &Thumbnail;
+	if (Thumbnail.Width > AtlasSize || Thumbnail.Height > AtlasSize)
+	{
+		const float Scale = (float)AtlasSize / FMath::Max(Thumbnail.Width, Thumbnail.Height);
+		Resized = Thumbnail;
+		FGhostscriptCore::ResizeBitmap(Resized, FMath::Clamp(FMath::FloorToInt(Thumbnail.Width * Scale), 1, AtlasSize), FMath::Clamp(FMath::FloorToInt(Thumbnail.Height * Scale), 1, AtlasSize));
+		Source = &Resized;
+	}
+
+	// 行に収まらなければ次の行へ、アトラスに収まらなければ次のアトラスへ
+	if (CursorX + Source->Width > AtlasSize)
+	{
+		CursorX = 0;
+		CursorY = Align(CursorY + RowHeight + ThumbnailPadding, ThumbnailAlignment);
+		RowHeight = 0;
+	}
+	if (Atlases.Num() == 0 || CursorY + Source->Height > AtlasSize)
+	{
+		FPageBitmap& Atlas = Atlases.AddDefaulted_GetRef();
+		Atlas.Width = AtlasSize;
+		Atlas.Height = AtlasSize;
+		Atlas.Pixels.SetNumZeroed(AtlasSize * AtlasSize * 4);
+		CursorX = 0;
+		CursorY = 0;
+		RowHeight = 0;
+	}
+
+	// 空ける部分には端のピクセルを繰り返して縮小したミップの端が暗くならないようにする
+	FPageBitmap& Atlas = Atlases.Last();
+	const int PaddedWidth = FMath::Min(Source->Width + ThumbnailPadding, AtlasSize - CursorX);
+	const int PaddedHeight = FMath::Min(Source->Height + ThumbnailPadding, AtlasSize - CursorY);
+	for (int Y = 0; Y < PaddedHeight; Y++)
+	{
+		const uint8* SourceRow = Source->Pixels.GetData() + FMath::Min(Y, Source->Height - 1) * Source->Width * 4;
+		uint8* DestRow = Atlas.Pixels.GetData() + ((CursorY + Y) * AtlasSize + CursorX) * 4;
+		FMemory::Memcpy(DestRow, SourceRow, Source->Width * 4);
+		for (int X = Source->Width; X < PaddedWidth; X++)
+		{
+			FMemory::Memcpy(DestRow + X * 4, SourceRow + (Source->Width - 1) * 4, 4);
+		}
+	}
+
+	Placements.Add(TPair<int, FIntRect>(Atlases.Num() - 1, FIntRect(CursorX, CursorY, CursorX + Source->Width, CursorY + Source->Height)));
+	CursorX = Align(CursorX + Source->Width + ThumbnailPadding, ThumbnailAlignment);
+	RowHeight = FMath::Max(RowHeight, Source->Height);
+}
+
+void FThumbnailAtlasBuilder::Finish(TArray<FPageBitmap>& OutAtlases, TArray<FPDFPageThumbnail>& OutThumbnails)
+{
+	// 最後のアトラスは使っている行まで切り詰める、ミップでも配置がずれないように高さは揃える単位の倍数
+	if (Atlases.Num() > 0)
+	{
+		FPageBitmap& Atlas = Atlases.Last();
+		Atlas.Height = FMath::Min(Align(CursorY + RowHeight + ThumbnailPadding, ThumbnailAlignment), AtlasSize);
+		Atlas.Pixels.SetNum(AtlasSize * Atlas.Height * 4);
+	}
+
+	OutThumbnails.Reset(Placements.Num());
+	for (const TPair<int, FIntRect>& Placement : Placements)
+	{
+		const FVector2D AtlasSizeInPixels(AtlasSize, Atlases[Placement.Key].Height);
+
+		FPDFPageThumbnail& Thumbnail = OutThumbnails.AddDefaulted_GetRef();
+		Thumbnail.AtlasIndex = Placement.Key;
+		Thumbnail.UVOffset = FVector2D(Placement.Value.Min) / AtlasSizeInPixels;
+		Thumbnail.UVSize = FVector2D(Placement.Value.Size()) / AtlasSizeInPixels;
+	}
+
+	OutAtlases = MoveTemp(Atlases);
+	Placements.Reset();
+	CursorX = 0;
+	CursorY = 0;
+	RowHeight = 0;
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GhostscriptCore.h"
+#include "PDF.h"
+
+// Packs page thumbnails into atlases row by row in page order
+// Thumbnails are aligned and padded so that the mips shown in the page list do not mix neighboring pages
+class FThumbnailAtlasBuilder
+{
+public:
+	FThumbnailAtlasBuilder(int InAtlasSize);
+
+	// Copy a thumbnail into the last atlas, starting a new atlas when it is full
+	// Thumbnails larger than an atlas are shrunk to fit
+	void Add(const FPageBitmap& Thumbnail);
+
+	// Crop the last atlas to the rows in use and get the location of each thumbnail in the atlases
+	void Finish(TArray<FPageBitmap>& OutAtlases, TArray<FPDFPageThumbnail>& OutThumbnails);
+
+private:
+	// Width and height of the atlases
+	int AtlasSize;
+
+	TArray<FPageBitmap> Atlases;
+
+	// Atlas index and region in pixels of each added thumbnail
+	TArray<TPair<int, FIntRect>> Placements;
+
+	// Where the next thumbnail goes in the last atlas
+	int CursorX;
+	int CursorY;
+	int RowHeight;
+};
@@ -4,10 +4,14 @@
 
 #include "CoreMinimal.h"
 #include "Kismet/BlueprintAsyncActionBase.h"
+#include "PDF.h"
+#include "PDFConversionQueue.h"
 #include "ConvertPdfToPdfAsset.generated.h"
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FLoadingCompletedPin, class UPDF*, PDF);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE(FFailedToLoadPin);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FConversionProgressPin, int, NumConvertedPages, int, NumPages);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE(FConversionCancelledPin);
 
 UCLASS()
 class PDFIMPORTER_API UConvertPdfToPdfAsset : public UBlueprintAsyncActionBase
@@ -23,8 +27,16 @@ public:
 	UPROPERTY(BlueprintAssignable)
 	FFailedToLoadPin Failed;
 
+	// Execution pin called after each converted page
+	UPROPERTY(BlueprintAssignable)
+	FConversionProgressPin Progress;
+
+	// Execution pin called when the conversion is cancelled
+	UPROPERTY(BlueprintAssignable)
+	FConversionCancelledPin Cancelled;
+
 private:
-	TSharedPtr<class FGhostscriptCore> GhostscriptCore;
+	TSharedPtr<FPDFConversionTask, ESPMode::ThreadSafe> ConversionTask;
 	const UObject* WorldContextObject;
 	bool bIsActive;
 
@@ -33,6 +45,9 @@ private:
 	int Dpi;
 	int FirstPage;
 	int LastPage;
+	bool bRenderPagesOnDemand;
+	EPDFPageCompression Compression;
+	EPDFConversionPriority Priority;
 
 public:
 	// Constructor
@@ -45,9 +60,23 @@ public:
 		const FString& PDF_FilePath, 
 		int Dpi = 150,
 		int FirstPage = 0,
-		int LastPage = 0
+		int LastPage = 0,
+		bool bRenderPagesOnDemand = false,
+		EPDFPageCompression Compression = EPDFPageCompression::Uncompressed,
+		EPDFConversionPriority Priority = EPDFConversionPriority::Normal
 	);
 
+	// Stop the conversion, the Cancelled pin is called instead of Completed
+	UFUNCTION(BlueprintCallable, Category = "PDFImporter")
+	void Cancel();
+
 	// UBlueprintAsyncActionBase interface
 	virtual void Activate() override;
+
+	// UObject interface
+	virtual void BeginDestroy() override;
+
+private:
+	// Called on the game thread when the conversion ends
+	void HandleConversionFinished(class UPDF* PDFAsset);
 };
\ No newline at end of file
@@ -2,11 +2,32 @@
 
 #include "CoreMinimal.h"
 #include "PDFImporter.h"
+#include "PDF.h"
 
 typedef int(*CreateAPIInstance)(void** Instance, void* CallerHandle);
 typedef void(*DeleteAPIInstance)(void* Instance);
 typedef int(*InitAPI)(void* Instance, int Argc, char** Argv);
 typedef int(*ExitAPI)(void* Instance);
+typedef int(*SetDisplayCallbackAPI)(void* Instance, void* Callback);
+typedef int(*SetStdioAPI)(void* Instance, int(*StdIn)(void*, char*, int), int(*StdOut)(void*, const char*, int), int(*StdErr)(void*, const char*, int));
+
+// Page image rendered by Ghostscript
+struct FPageBitmap
+{
+	FPageBitmap() : Width(0), Height(0) {}
+
+	int Width;
+	int Height;
+
+	// Pixel data in BGRA8 format, top row first
+	TArray<uint8> Pixels;
+};
+
+// Receives a page as soon as it is available, return false to stop converting
+typedef TFunctionRef<bool(int PageNumber, FPageBitmap& Bitmap)> FPageBitmapCallback;
+
+// Receives the number of converted pages and the total number of pages (0 if unknown), return false to cancel
+typedef TFunction<bool(int NumConvertedPages, int NumPages)> FConversionProgressCallback;
 
 class PDFIMPORTER_API FGhostscriptCore
 {
@@ -20,31 +41,168 @@ private:
 	InitAPI Init;
 	ExitAPI Exit;
 
+	// Optional, nullptr if the dll does not support the display device
+	SetDisplayCallbackAPI SetDisplayCallback;
+	SetStdioAPI SetStdio;
+
 	TSharedPtr<class IImageWrapper> ImageWrapper;
 
+	// Threads that run Ghostscript instances in parallel, created on first use
+	class FQueuedThreadPool* RenderThreadPool;
+	FCriticalSection RenderThreadPoolCriticalSection;
+
+	// Caps the Ghostscript instances running at the same time across all conversions
+	TSharedPtr<class FRenderSlotScheduler> RenderSlots;
+
+	// Pages rendered before, stored on disk
+	TSharedPtr<class FPDFRenderCache> RenderCache;
+
 public:
 	// The path to the directory where the page's texture assets are located
 	static const FString PagesDirectoryPath;
 
 public:
 	// Convert PDF to PDF asset
-	class UPDF* ConvertPdfToPdfAsset(const FString& InputPath, int Dpi, int FirstPage, int LastPage, bool bIsImportIntoEditor = false);
+	// Page textures imported into the editor stream as virtual textures if bUseVirtualTextures is set and the project supports them
+	// Virtual texture pages can not be drawn on a canvas or a UMG brush, and the viewer draws them only from the source PDF, so the importer does not use them
+	// Returns nullptr as soon as OnProgress cancels, without waiting for the textures of pages already converted
+	class UPDF* ConvertPdfToPdfAsset(const FString& InputPath, int Dpi, int FirstPage, int LastPage, bool bIsImportIntoEditor = false,
+		EPDFPageCompression Compression = EPDFPageCompression::Uncompressed, bool bUseVirtualTextures = false, const FConversionProgressCallback& OnProgress = FConversionProgressCallback());
+
+#if WITH_EDITORONLY_DATA
+	// Render PDF again and replace only the page textures whose pixels changed, keeping the compression of the PDF asset
+	// Pages stored as virtual textures are all replaced with regular textures, so that the PDF asset can draw them without the source PDF
+	// Changed pages are written to new textures and swapped in only when everything succeeded, so a failure leaves the PDF asset as it was
+	// Replaced textures and textures of pages and thumbnail atlases that no longer exist are returned in OutRemovedPages
+	bool ReimportPdfAsset(class UPDF* PDFAsset, const FString& InputPath, int Dpi, int FirstPage, int LastPage, TArray<class UTexture2D*>& OutRemovedPages);
+
+	// Destroy the page textures and thumbnail atlases of a PDF asset returned by ConvertPdfToPdfAsset that will not be used, deleting their saved packages
+	void DiscardPdfAsset(class UPDF* PDFAsset);
+#endif
+
+	// Create PDF asset that renders each page when it is first requested
+	class UPDF* OpenPdfAsset(const FString& InputPath, int Dpi, int FirstPage, int LastPage, EPDFPageCompression Compression = EPDFPageCompression::Uncompressed);
+
+	// Get number of pages in PDF without rendering it, returns 0 on failure
+	int GetPageCount(const FString& InputPath);
+
+	// Get the size of a page in points with its rotation applied, returns false on failure
+	bool GetPageSize(const FString& InputPath, int PageNumber, FVector2D& OutSize);
+
+	// Render a region of a page given in pixels from the top left of the page at the specified resolution
+	// PageSize is the size of the page in points returned by GetPageSize, needs the display device
+	bool RenderPageRegion(const FString& InputPath, int PageNumber, int Dpi, const FVector2D& PageSize, const FIntRect& Region, FPageBitmap& OutBitmap);
+
+	// Run a task that uses Ghostscript on the render threads, which have enough stack for it
+	void StartRenderTask(TFunction<void()> Task);
+
+	// Render PDF pages across multiple Ghostscript instances and pass them to the callback in page order
+	// Returns false if rendering failed or the callback stopped converting
+	bool ConvertPdfToBitmaps(const FString& InputPath, int Dpi, int FirstPage, int LastPage, FPageBitmapCallback OnPageConverted);
+
+	// Create UTexture2D from page bitmap
+	bool LoadTexture2DFromBitmap(const FPageBitmap& Bitmap, class UTexture2D*& LoadedTexture, EPDFPageCompression Compression = EPDFPageCompression::Uncompressed);
+
+	// Create UTexture2D from page texture data encoded in advance
+	bool LoadTexture2DFromTextureData(const struct FPageTextureData& TextureData, class UTexture2D*& LoadedTexture);
+
+	// Shrink the page bitmap if it is larger than the largest texture the RHI can create
+	// Pages converted at runtime are always one full texture, so a large page at a high DPI still needs its whole size in memory up to that limit
+	static void FitBitmapToMaxTextureSize(FPageBitmap& Bitmap);
+
+	// Scale the page bitmap to the specified size
+	static void ResizeBitmap(FPageBitmap& Bitmap, int Width, int Height);
 
 private:
+
+	// Render the page range with Ghostscript, falling back to a single instance if parallel rendering fails
+	// Returns false without rendering again if the callback stopped converting
+	bool RenderPageRange(const FString& InputPath, int Dpi, int FirstPage, int LastPage, const FString& CacheKey, FPageBitmapCallback OnPageConverted);
+
+	// Run render workers that feed a bounded queue consumed by the calling thread, returns false if a worker failed or the callback stopped converting
+	// bOutIsStopped is set if the callback stopped converting, so that the caller does not render the remaining pages again
+	// Rendered pages are also written to the render cache if CacheKey is not empty
+	bool RunRenderPipeline(const FString& InputPath, int Dpi, int FirstPage, int LastPage, int NumWorkers, const FString& CacheKey, FPageBitmapCallback OnPageConverted, int& OutNextPage, bool& bOutIsStopped);
+
+	// Get the render cache key of the document rendered with the current options, empty if the cache is not used
+	FString GetRenderCacheKey(const FString& InputPath, int Dpi);
+
+	// Render PDF pages with a single Ghostscript instance
+	bool RenderPages(const FString& InputPath, int Dpi, int FirstPage, int LastPage, FPageBitmapCallback OnPageRendered);
+
+	// Render PDF pages straight into memory using the Ghostscript display device
+	bool RenderPagesWithDisplay(const FString& InputPath, int Dpi, int FirstPage, int LastPage, FPageBitmapCallback OnPageRendered);
+
+	// Render PDF pages to jpeg files in a working directory and decode them
+	bool RenderPagesViaJpeg(const FString& InputPath, int Dpi, int FirstPage, int LastPage, FPageBitmapCallback OnPageRendered);
+
 	// Convert PDF to multiple jpeg images using Ghostscript API
 	bool ConvertPdfToJpeg(const FString& InputPath, const FString& OutputPath, int Dpi, int FirstPage, int LastPage);
 
-	// Create UTexture2D from image files in directory
-	bool LoadTexture2DFromFile(const FString& FilePath, class UTexture2D*& LoadedTexture);
+	// Arguments common to all rendering devices
+	TArray<FString> MakeRenderingArguments(int Dpi, int FirstPage, int LastPage) const;
+
+	// Run Ghostscript with the specified arguments
+	// DisplayContext receives the pages of the display device, StandardOutput receives what Ghostscript prints
+	bool ExecuteGhostscript(const TArray<FString>& Arguments, void* DisplayContext = nullptr, FString* StandardOutput = nullptr);
+
+	// Get the thread pool for rendering
+	class FQueuedThreadPool* GetRenderThreadPool();
+
+	// Decode image file into a page bitmap
+	bool LoadBitmapFromFile(const FString& FilePath, FPageBitmap& OutBitmap);
+
+	// Create the page texture for runtime or editor from page bitmap
+	// PageIndex selects the package of the texture asset
+	bool CreatePageTexture(const FPageBitmap& Bitmap, int PageIndex, const FString& Filename, bool bIsImportIntoEditor, EPDFPageCompression Compression, bool bVirtualTexture, class UTexture2D*& LoadedTexture);
 
 #if WITH_EDITORONLY_DATA
-	// Create texture asset from image files in directory
-	bool CreateTextureAssetFromFile(const FString& FilePath, class UTexture2D*& LoadedTexture);
+	// Create texture asset from page bitmap in the specified package of the PDF, the package is not saved
+	// The texture is named after the PDF unless AssetName is specified
+	bool CreateTextureAssetFromBitmap(const FPageBitmap& Bitmap, const FString& Filename, EPDFPageCompression Compression, bool bVirtualTexture, class UTexture2D*& LoadedTexture, int PackageIndex = 0, const FString& AssetName = FString());
+
+	// Get the package that stores the texture asset of a page, pages are split into packages of PagesPerPackage
+	static int GetPagePackageIndex(int PageIndex);
+
+	// Package index of the thumbnail atlases, kept apart from the pages so that loading the PDF asset loads no page texture
+	static const int ThumbnailPackageIndex = INDEX_NONE;
+
+	// Get the name of the package with the specified index that stores texture assets of the PDF
+	static FString GetTexturePackageName(const FString& Filename, int PackageIndex);
+
+	// Render all pages at the thumbnail resolution and pack them into new atlas texture assets, the package is not saved
+	// Nothing is created if it fails
+	bool BuildThumbnailAtlases(const FString& InputPath, int FirstPage, int LastPage, const FString& Filename,
+		TArray<class UTexture2D*>& OutAtlases, TArray<FPDFPageThumbnail>& OutThumbnails);
+
+	// Write page bitmap into the source and platform data of texture asset
+	// Compressed and virtual textures are built on the engine's worker threads until FinishTextureAssets is called
+	void WriteBitmapToTextureAsset(const FPageBitmap& Bitmap, EPDFPageCompression Compression, bool bVirtualTexture, class UTexture2D* Texture);
+
+	// Wait for the compressed and virtual textures written by WriteBitmapToTextureAsset to be built
+	void FinishTextureAssets(const TArray<class UTexture2D*>& Textures, EPDFPageCompression Compression, bool bVirtualTexture);
+
+	// Save the package containing texture asset
+	// If bAsyncWrite is set the file is written in the background until UPackage::WaitForAsyncFileWrites is called
+	bool SaveTextureAssetPackage(class UTexture2D* Texture, bool bAsyncWrite = false);
+
+	// Save each package containing the texture assets once, writing the files in parallel and waiting for all of them
+	// OutWriteSeconds receives the time spent waiting for the writes after the last package was serialized
+	bool SaveTextureAssetPackages(const TArray<class UTexture2D*>& Textures, double* OutWriteSeconds = nullptr);
+
+	// Destroy texture assets created by a conversion that did not finish
+	void DiscardTextureAssets(const TArray<class UTexture2D*>& Textures);
 #endif
 
 	// 
 	TArray<char> FStringToCharPtr(const FString& Text);
 
+	// Get the hash of page pixels to detect changed pages
+	FString GetPageBitmapHash(const FPageBitmap& Bitmap) const;
+
+	// Whether page textures imported into the editor can stream as virtual textures
+	bool CanUseVirtualTextures() const;
+
 	// Get the size of FString data
 	int GetFStringSize(const FString& Text);
 
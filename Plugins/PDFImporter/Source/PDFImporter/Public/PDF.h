@@ -6,6 +6,20 @@
 #include "UObject/NoExportTypes.h"
 #include "PDF.generated.h"
 
+struct FPageBitmap;
+
+// Format of page textures
+UENUM(BlueprintType)
+enum class EPDFPageCompression : uint8
+{
+	// BGRA8 without mipmaps
+	Uncompressed,
+	// BC1 with mipmaps, an eighth of the memory of uncompressed pages
+	BC1,
+	// BC7 with mipmaps, higher quality at a quarter of the memory, pages converted at runtime use BC1
+	BC7
+};
+
 USTRUCT(BlueprintType)
 struct FPageRange
 {
@@ -22,6 +36,53 @@ public:
 	int LastPage;
 };
 
+// Location of a page in the thumbnail atlases
+USTRUCT(BlueprintType)
+struct FPDFPageThumbnail
+{
+	GENERATED_BODY()
+
+public:
+	FPDFPageThumbnail() : AtlasIndex(INDEX_NONE), UVOffset(0.0f, 0.0f), UVSize(0.0f, 0.0f) {}
+
+	// Index of the atlas in ThumbnailAtlases
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Thumbnail")
+	int AtlasIndex;
+
+	// Top left corner of the page in the atlas in UV coordinates
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Thumbnail")
+	FVector2D UVOffset;
+
+	// Size of the page in the atlas in UV coordinates
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Thumbnail")
+	FVector2D UVSize;
+};
+
+// Size and memory of a page, stored inline so that it can be read without loading the page texture
+USTRUCT(BlueprintType)
+struct FPDFPageInfo
+{
+	GENERATED_BODY()
+
+public:
+	FPDFPageInfo() : Width(0), Height(0), Dpi(0), SizeBytes(0) {}
+
+	// Size of the page texture in pixels
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "PageInfo")
+	int Width;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "PageInfo")
+	int Height;
+
+	// Resolution the page was rendered at
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "PageInfo")
+	int Dpi;
+
+	// Memory of the page texture with all mips in bytes
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "PageInfo")
+	int SizeBytes;
+};
+
 UCLASS(BlueprintType)
 class PDFIMPORTER_API UPDF : public UObject
 {
@@ -36,10 +97,38 @@ public:
 	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = "PDF")
 	int Dpi;
 
-	// PDF page textures
-	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = "PDF")
+	// PDF page textures that are loaded, nullptr for pages that have not been loaded or rendered yet
+	UPROPERTY(Transient, VisibleAnywhere, BlueprintReadWrite, Category = "PDF")
 	TArray<class UTexture2D*> Pages;
 
+	// Page texture assets, saved instead of Pages so that loading the PDF does not load every page
+	UPROPERTY(VisibleAnywhere, Category = "PDF")
+	TArray<TSoftObjectPtr<class UTexture2D>> PageAssets;
+
+	// Size and memory of each page
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "PDF")
+	TArray<FPDFPageInfo> PageInfos;
+
+	// Format of the page textures
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "PDF")
+	EPDFPageCompression Compression;
+
+	// Whether the page textures stream as virtual textures so that only the sampled tiles are resident
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "PDF")
+	bool bVirtualTexturePages;
+
+	// Low resolution images of all pages packed into a few textures, to navigate without loading the pages
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Thumbnails")
+	TArray<class UTexture2D*> ThumbnailAtlases;
+
+	// Location of each page in ThumbnailAtlases
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Thumbnails")
+	TArray<FPDFPageThumbnail> PageThumbnails;
+
+	// Hash of the rendered pixels of each page, used to find the pages that changed on reimport
+	UPROPERTY()
+	TArray<FString> PageHashes;
+
 	// Data for import setting
 #if WITH_EDITORONLY_DATA
 	UPROPERTY(VisibleAnywhere, Instanced, Category = "ImportSettings")
@@ -51,6 +140,17 @@ public:
 	UPROPERTY()
 	FDateTime TimeStamp;
 
+	// Whether page textures are rendered from Filename when they are first requested
+	UPROPERTY(Transient, VisibleAnywhere, BlueprintReadOnly, Category = "PDF")
+	bool bRenderPagesOnDemand;
+
+private:
+	// Indexes of pages being rendered in the background
+	TSet<int> PrefetchingPages;
+
+	// Pages that the page cache must not release
+	TSet<int> PinnedPages;
+
 public:
 	// Get the texture of the specified page
 	UFUNCTION(BlueprintCallable, Category = "PDF")
@@ -60,13 +160,74 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "PDF")
 	int GetPageCount() const { return Pages.Num(); }
 
+	// Get the texture of the specified page without rendering or loading it, nullptr if it is not in memory yet
+	UFUNCTION(BlueprintCallable, Category = "PDF")
+	UTexture2D* FindPageTexture(int Page) const;
+
+	// Render or load the specified pages in the background
+	UFUNCTION(BlueprintCallable, Category = "PDF")
+	void PrefetchPages(int FirstPage, int LastPage);
+
+	// Get the size and memory of the specified page without loading it, returns false if it is not known
+	UFUNCTION(BlueprintCallable, Category = "PDF")
+	bool GetPageInfo(int Page, FPDFPageInfo& OutInfo) const;
+
+	// Whether missing pages can be requested with PrefetchPages instead of waiting for GetPageTexture
+	bool LoadsPagesInBackground() const { return bRenderPagesOnDemand || PageAssets.Num() > 0; }
+
+	// Load the textures of all pages synchronously, for editor operations that touch every page
+	void LoadAllPages();
+
+	// Update PageAssets and PageInfos from the loaded page textures
+	// Called when saving, and after an import or reimport assigns Pages so that the asset registry tags are right before the first save
+	void UpdatePageAssets();
+
+	// Get the atlas texture and the region of the specified page in it, returns false if the PDF has no thumbnails
+	UFUNCTION(BlueprintCallable, Category = "PDF")
+	bool GetPageThumbnail(int Page, UTexture2D*& OutAtlas, FVector2D& OutUVOffset, FVector2D& OutUVSize) const;
+
+	// Keep the page texture resident while it is displayed, only affects PDFs rendered on demand
+	UFUNCTION(BlueprintCallable, Category = "PDF")
+	void PinPage(int Page) { PinnedPages.Add(Page); }
+
+	// Allow the page cache to release the page texture again
+	UFUNCTION(BlueprintCallable, Category = "PDF")
+	void UnpinPage(int Page) { PinnedPages.Remove(Page); }
+
+	// Whether the page is pinned
+	bool IsPagePinned(int Page) const { return PinnedPages.Contains(Page); }
+
+	// Whether the page is being rendered in the background
+	bool IsPagePrefetching(int Page) const { return PrefetchingPages.Contains(Page - 1); }
+
 public:
 	// UObject interface
 	virtual void Serialize(FArchive& Ar) override;
 	virtual void PostInitProperties() override;
 	virtual void PostLoad() override;
+	virtual void BeginDestroy() override;
 #if WITH_EDITORONLY_DATA
+	// Exports the source file, source hash, page count, page range, DPI, distinct page dimensions (capped) and resident bytes, so that they can be queried without loading the pages
 	virtual void GetAssetRegistryTags(TArray<FAssetRegistryTag>& OutTags) const override;
 #endif
 	// End of UObject interface
+
+private:
+	// Render the page if it has not been rendered yet
+	UTexture2D* LoadPage(int PageIndex);
+
+	// Render pages in the background so that they are ready when requested
+	void StartPrefetch(int FirstIndex, int LastIndex);
+
+	// Called on the game thread when the texture of a page rendered in the background is created, nullptr if it failed
+	void OnPagePrefetched(int PageIndex, UTexture2D* Texture);
+
+	// Load the page texture asset synchronously if it is not loaded yet
+	UTexture2D* LoadPageAsset(int PageIndex);
+
+	// Load page texture assets with the streamable manager
+	void StartPageAssetLoad(int FirstIndex, int LastIndex);
+
+	// Called when page texture assets loaded in the background are available
+	void OnPageAssetsLoaded(TArray<int> PageIndexes);
 };
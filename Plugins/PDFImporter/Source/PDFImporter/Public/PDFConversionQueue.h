@@ -0,0 +1,125 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/ThreadSafeBool.h"
+#include "PDF.h"
+#include "PDFConversionQueue.generated.h"
+
+// Order in which waiting conversions start
+UENUM(BlueprintType)
+enum class EPDFConversionPriority : uint8
+{
+	Low,
+	Normal,
+	High
+};
+
+// Options of a conversion started at runtime
+struct FPDFConversionOptions
+{
+	FPDFConversionOptions()
+		: Dpi(150), FirstPage(0), LastPage(0), bRenderPagesOnDemand(false), Compression(EPDFPageCompression::Uncompressed) {}
+
+	FString InputPath;
+	int Dpi;
+	int FirstPage;
+	int LastPage;
+
+	// Only count the pages and render each page when it is first requested
+	bool bRenderPagesOnDemand;
+
+	EPDFPageCompression Compression;
+};
+
+// Receives the number of converted pages and the total number of pages (0 if unknown)
+DECLARE_DELEGATE_TwoParams(FOnPDFConversionProgress, int, int);
+
+// Receives the converted PDF asset, nullptr if the conversion failed or was cancelled
+DECLARE_DELEGATE_OneParam(FOnPDFConversionFinished, class UPDF*);
+
+// Handle of a conversion started with FPDFConversionQueue
+// The delegates are called on the game thread, OnFinished exactly once
+class PDFIMPORTER_API FPDFConversionTask : public TSharedFromThis<FPDFConversionTask, ESPMode::ThreadSafe>
+{
+private:
+	friend class FPDFConversionQueue;
+
+	FPDFConversionOptions Options;
+	EPDFConversionPriority Priority;
+	FOnPDFConversionProgress OnProgress;
+	FOnPDFConversionFinished OnFinished;
+
+	// Checked by the conversion between pages
+	FThreadSafeBool bIsCancelled;
+
+	// Whether the conversion left the queue, only used on the game thread
+	bool bIsStarted;
+	bool bIsFinished;
+
+public:
+	// Constructor
+	FPDFConversionTask(const FPDFConversionOptions& InOptions, EPDFConversionPriority InPriority, const FOnPDFConversionProgress& InOnProgress, const FOnPDFConversionFinished& InOnFinished);
+
+	// Stop the conversion before its next page and release its render workers
+	// A conversion that has not started yet is removed from the queue right away
+	void Cancel();
+
+	// Whether Cancel was called
+	bool IsCancelled() const { return bIsCancelled; }
+
+	// Whether the conversion has started converting pages
+	bool IsStarted() const { return bIsStarted; }
+
+	// Whether OnFinished has been called
+	bool IsFinished() const { return bIsFinished; }
+
+	// Get the priority used while the conversion waits to start
+	EPDFConversionPriority GetPriority() const { return Priority; }
+
+	// Change the priority, only affects a conversion that has not started yet
+	void SetPriority(EPDFConversionPriority InPriority) { Priority = InPriority; }
+
+	// Get the options of the conversion
+	const FPDFConversionOptions& GetOptions() const { return Options; }
+};
+
+// Runs the conversions started at runtime in the background
+// Conversions beyond the limit of the project settings wait and start in order of priority
+class PDFIMPORTER_API FPDFConversionQueue : public TSharedFromThis<FPDFConversionQueue, ESPMode::ThreadSafe>
+{
+private:
+	// Conversions that have not started yet, in the order they were queued
+	TArray<TSharedRef<FPDFConversionTask, ESPMode::ThreadSafe>> WaitingTasks;
+
+	// Number of conversions converting pages
+	int NumRunningTasks;
+
+public:
+	// Constructor
+	FPDFConversionQueue();
+
+	// Queue a conversion, must be called on the game thread
+	TSharedRef<FPDFConversionTask, ESPMode::ThreadSafe> StartConversion(const FPDFConversionOptions& Options, EPDFConversionPriority Priority,
+		const FOnPDFConversionProgress& OnProgress, const FOnPDFConversionFinished& OnFinished);
+
+	// Finish the cancelled conversions that have not started yet
+	void RemoveCancelledConversions();
+
+	// Get the number of conversions waiting to start
+	int GetNumWaitingConversions() const { return WaitingTasks.Num(); }
+
+	// Get the number of conversions converting pages
+	int GetNumRunningConversions() const { return NumRunningTasks; }
+
+private:
+	// Start waiting conversions while there are free slots
+	void StartWaitingConversions();
+
+	// Convert the PDF on a worker thread
+	void RunConversion(const TSharedRef<FPDFConversionTask, ESPMode::ThreadSafe>& Task);
+
+	// Deliver the result on the game thread and start the next conversion
+	void FinishConversion(const TSharedRef<FPDFConversionTask, ESPMode::ThreadSafe>& Task, class UPDF* PDFAsset);
+};
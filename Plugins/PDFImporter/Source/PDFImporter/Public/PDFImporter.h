@@ -10,6 +10,15 @@ private:
 	// An instance with the same life as this module class
 	TSharedPtr<class FGhostscriptCore> GhostscriptCore;
 
+	// Page textures of PDFs rendered on demand
+	TSharedPtr<class FPDFPageCache> PageCache;
+
+	// Conversions started at runtime, thread safe because conversions running on worker threads hold weak references to it
+	TSharedPtr<class FPDFConversionQueue, ESPMode::ThreadSafe> ConversionQueue;
+
+	// Creates runtime page textures on the game thread in time-sliced batches
+	TSharedPtr<class FPageTextureUploader> TextureUploader;
+
 public:
 	/** IModuleInterface implementation */
 	virtual void StartupModule() override;
@@ -17,6 +26,15 @@ public:
 
 	// Get an instance of GhostscriptCore
 	TSharedPtr<class FGhostscriptCore> GetGhostscriptCore() const { return GhostscriptCore; }
+
+	// Get the page cache shared by all PDFs
+	TSharedPtr<class FPDFPageCache> GetPageCache() const { return PageCache; }
+
+	// Get the queue of conversions started at runtime
+	TSharedPtr<class FPDFConversionQueue, ESPMode::ThreadSafe> GetConversionQueue() const { return ConversionQueue; }
+
+	// Get the uploader that creates runtime page textures
+	TSharedPtr<class FPageTextureUploader> GetTextureUploader() const { return TextureUploader; }
 };
 
 DEFINE_LOG_CATEGORY_STATIC(PDFImporter, Log, All);
\ No newline at end of file
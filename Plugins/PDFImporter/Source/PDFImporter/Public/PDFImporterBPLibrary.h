@@ -4,6 +4,7 @@
 
 #include "Kismet/BlueprintFunctionLibrary.h"
 #include "PDF.h"
+#include "PDFPageCache.h"
 #include "PDFImporterBPLibrary.generated.h"
 
 /* 
@@ -48,6 +49,10 @@ public:
 	UFUNCTION(BlueprintPure, meta = (BlueprintAutocast, DisplayName = "ToString(PageRange)", CompactNodeTitle = "->"))
 	static FString ConvertFPageRangeToFString(FPageRange InPageRange);
 
+	// Get the counters of the page cache used by PDFs rendered on demand
+	UFUNCTION(BlueprintPure, Category = "PDFImporter | PageCache")
+	static FPDFPageCacheStats GetPageCacheStats();
+
 private:
 	// Get window handle
 	static void* GetWindowHandle();
@@ -0,0 +1,74 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectMacros.h"
+#include "UObject/Object.h"
+#include "PDFImporterSettings.generated.h"
+
+/**
+ * Project settings for converting PDF files.
+ */
+UCLASS(config=Engine, defaultconfig)
+class PDFIMPORTER_API UPDFImporterSettings : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	/** Number of Ghostscript instances that render pages in parallel, shared by all conversions running at the same time. 0 uses the number of CPU cores. */
+	UPROPERTY(config, EditAnywhere, Category = "Rendering", meta = (ClampMin = 0, UIMin = 0, ConfigRestartRequired = true))
+	int NumRenderWorkers;
+
+	/** Maximum number of rendered pages waiting to become textures. Limits memory used while converting long documents. */
+	UPROPERTY(config, EditAnywhere, Category = "Rendering", meta = (ClampMin = 1, UIMin = 1))
+	int MaxPendingPages;
+
+	/** Number of pages after the requested one that are rendered in the background when pages are rendered on demand. */
+	UPROPERTY(config, EditAnywhere, Category = "Rendering", meta = (ClampMin = 0, UIMin = 0))
+	int PrefetchPages;
+
+	/** Memory budget in megabytes for the page textures of PDFs rendered on demand or loaded page by page. Least recently used pages are released first. 0 is unlimited. */
+	UPROPERTY(config, EditAnywhere, Category = "Rendering", meta = (ClampMin = 0, UIMin = 0))
+	int PageCacheBudgetMB;
+
+	/** Number of conversions started at runtime that convert pages at the same time. Further conversions wait in order of priority. 0 is unlimited. */
+	UPROPERTY(config, EditAnywhere, Category = "Runtime", meta = (ClampMin = 0, UIMin = 0))
+	int MaxConcurrentConversions;
+
+	/** Time in milliseconds the game thread spends per frame creating the page textures of runtime conversions. At least one texture is created per frame. */
+	UPROPERTY(config, EditAnywhere, Category = "Runtime", meta = (ClampMin = 0, UIMin = 0, UIMax = 16))
+	float TextureCreationBudgetMs;
+
+	/** Whether rendered pages are kept in Saved/PDFImporter/RenderCache so that converting the same PDF again skips Ghostscript. */
+	UPROPERTY(config, EditAnywhere, Category = "RenderCache")
+	bool bUseRenderCache;
+
+	/** Maximum size in megabytes of the render cache on disk. Least recently used pages are deleted first. */
+	UPROPERTY(config, EditAnywhere, Category = "RenderCache", meta = (ClampMin = 1, UIMin = 1, EditCondition = "bUseRenderCache"))
+	int RenderCacheSizeMB;
+
+	/** Whether rendered pages are also shared through the derived data cache, so that machines using the same shared DDC skip Ghostscript for PDFs rendered elsewhere. Editor only. */
+	UPROPERTY(config, EditAnywhere, Category = "RenderCache", meta = (EditCondition = "bUseRenderCache"))
+	bool bUseDerivedDataCache;
+
+	/** Number of page textures stored in each package of an imported PDF. Loading a page loads its whole package, so smaller packages load less at the cost of more files. 0 stores all pages in one package. */
+	UPROPERTY(config, EditAnywhere, Category = "Packages", meta = (ClampMin = 0, UIMin = 0))
+	int PagesPerPackage;
+
+	/** Resolution of the page thumbnails rendered on import and packed into atlas textures of the PDF asset. 0 disables thumbnails. */
+	UPROPERTY(config, EditAnywhere, Category = "Thumbnails", meta = (ClampMin = 0, UIMin = 0, UIMax = 72))
+	int ThumbnailDpi;
+
+	/** Width and height of the thumbnail atlas textures. */
+	UPROPERTY(config, EditAnywhere, Category = "Thumbnails", meta = (ClampMin = 256, ClampMax = 8192))
+	int ThumbnailAtlasSize;
+
+public:
+	UPDFImporterSettings()
+		: NumRenderWorkers(0), MaxPendingPages(8), PrefetchPages(2), PageCacheBudgetMB(256), MaxConcurrentConversions(2), TextureCreationBudgetMs(2.f)
+		, bUseRenderCache(true), RenderCacheSizeMB(2048), bUseDerivedDataCache(true), PagesPerPackage(32), ThumbnailDpi(24), ThumbnailAtlasSize(2048) {}
+
+	// Get the number of workers actually used for rendering
+	int GetNumRenderWorkers() const;
+};
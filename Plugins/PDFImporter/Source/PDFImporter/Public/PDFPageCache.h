@@ -0,0 +1,87 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/WeakObjectPtr.h"
+#include "PDFPageCache.generated.h"
+
+// Counters of the page texture cache
+USTRUCT(BlueprintType)
+struct FPDFPageCacheStats
+{
+	GENERATED_BODY()
+
+public:
+	FPDFPageCacheStats() : Hits(0), Misses(0), Evictions(0), ResidentPages(0), ResidentMegabytes(0.f) {}
+
+	// Number of requests for pages that were already rendered
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "PageCache")
+	int Hits;
+
+	// Number of requests that had to render the page
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "PageCache")
+	int Misses;
+
+	// Number of page textures released to stay within the budget
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "PageCache")
+	int Evictions;
+
+	// Number of page textures currently held by the cache
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "PageCache")
+	int ResidentPages;
+
+	// Memory used by the page textures held by the cache
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "PageCache")
+	float ResidentMegabytes;
+};
+
+// Keeps the page textures of PDFs rendered on demand or loaded page by page within a memory budget shared by all PDFs
+// Textures that have not been used for the longest time are released first, pinned pages are never released
+class PDFIMPORTER_API FPDFPageCache
+{
+private:
+	struct FEntry
+	{
+		FEntry() : PageIndex(0), Size(0), LastUsed(0) {}
+
+		TWeakObjectPtr<class UPDF> PDF;
+		int PageIndex;
+		int64 Size;
+		uint64 LastUsed;
+	};
+
+	// Resident pages keyed by PDF and page index
+	TMap<TPair<const class UPDF*, int>, FEntry> Entries;
+
+	// Incremented on every access to order the entries
+	uint64 UseCounter;
+
+	// Total size of the resident page textures
+	int64 ResidentBytes;
+
+	FPDFPageCacheStats Stats;
+
+public:
+	// Constructor
+	FPDFPageCache();
+
+	// Notify that a resident page was requested
+	void NotifyHit(class UPDF* PDF, int PageIndex);
+
+	// Notify that a requested page was not resident
+	void NotifyMiss();
+
+	// Register a newly rendered page texture and release old pages if over budget
+	void AddPage(class UPDF* PDF, int PageIndex, class UTexture2D* Texture);
+
+	// Forget all pages of the PDF
+	void RemovePDF(const class UPDF* PDF);
+
+	// Get the counters
+	FPDFPageCacheStats GetStats() const;
+
+private:
+	// Release least recently used pages until the cache fits in the budget
+	void EvictToBudget(const TPair<const class UPDF*, int>& KeepKey);
+};
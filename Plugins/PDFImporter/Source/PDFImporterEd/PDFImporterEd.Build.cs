@@ -35,6 +35,7 @@ public class PDFImporterEd : ModuleRules
                 "Projects",
                 "PropertyEditor",
                 "EditorStyle",
+                "Settings",
 				// ... add private dependencies that you statically link with here ...	
 			}
 			);
@@ -7,12 +7,14 @@
 #include "Framework/Application/SlateApplication.h"
 #include "Editor/MainFrame/Public/Interfaces/IMainFrameModule.h"
 #include "ObjectTools.h"
+#include "Misc/ScopedSlowTask.h"
 #include "Editor.h"
 
 #define LOCTEXT_NAMESPACE "PDFFactory"
 
 UPDFFactory::UPDFFactory(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
+	, BatchImportOptions(nullptr)
 {
 	SupportedClass = UPDF::StaticClass();
 	bEditorImport = true;
@@ -47,34 +49,83 @@ UObject* UPDFFactory::FactoryCreateFile(
 	bool& bOutOperationCanceled
 )
 {
-	TSharedPtr<SPDFImportOptions> Options;
-	UPDFImportOptions* Result = NewObject<UPDFImportOptions>();
-	ShowImportOptionWindow(Options, Filename, Result);
-
-	if (Options->ShouldImport())
+	// uSăC|[gvI΂ꂽꍇ͎c̃t@Cɂݒg
+	UPDFImportOptions* Result = BatchImportOptions;
+	if (Result == nullptr)
 	{
-		UPDF* NewPDF = CastChecked<UPDF>(StaticConstructObject_Internal(InClass, InParent, InName, Flags));
-		UPDF* LoadedPDF = GhostscriptCore->ConvertPdfToPdfAsset(Filename, Result->Dpi, Result->FirstPage, Result->LastPage, true);
+		TSharedPtr<SPDFImportOptions> Options;
+		Result = NewObject<UPDFImportOptions>();
+		ShowImportOptionWindow(Options, Filename, Result);
 
-		if (LoadedPDF != nullptr)
+		if (!Options->ShouldImport())
 		{
-			NewPDF->PageRange = LoadedPDF->PageRange;
-			NewPDF->Dpi = LoadedPDF->Dpi;
-			NewPDF->Pages = LoadedPDF->Pages;
-
-			NewPDF->Filename = Filename;
-			NewPDF->TimeStamp = IFileManager::Get().GetTimeStamp(*Filename);
-			NewPDF->AssetImportData = NewObject<UAssetImportData>();
-			NewPDF->AssetImportData->SourceData.Insert({ NewPDF->Filename, NewPDF->TimeStamp });
+			bOutOperationCanceled = true;
+			return nullptr;
 		}
 
-		return NewPDF;
+		if (Options->ShouldImportAll())
+		{
+			BatchImportOptions = Result;
+		}
 	}
-	else
+
+	// ̃t@CC|[gꍇAssetTools̐i_CAO̒ɕ\
+	FScopedSlowTask SlowTask(1.0f, FText::Format(LOCTEXT("ImportingPdf", "Importing {0}"), FText::FromString(FPaths::GetCleanFilename(Filename))));
+	SlowTask.MakeDialog(true);
+
+	// zeNX`̃y[W̓LoXUMG̃uVŕ`łAr[A[PDFȂƕ\łȂ̂Œʏ̃eNX`ŃC|[g
+	int NumReportedPages = 0;
+	UPDF* LoadedPDF = GhostscriptCore->ConvertPdfToPdfAsset(Filename, Result->Dpi, Result->FirstPage, Result->LastPage, true, Result->Compression, false, [&](int NumConvertedPages, int NumPages)
+	{
+		if (NumPages > 0 && NumConvertedPages > NumReportedPages)
+		{
+			SlowTask.EnterProgressFrame((float)(NumConvertedPages - NumReportedPages) / NumPages,
+				FText::Format(LOCTEXT("ImportingPdfPage", "Importing {0} (page {1} of {2})"), FText::FromString(FPaths::GetCleanFilename(Filename)), NumConvertedPages, NumPages));
+			NumReportedPages = NumConvertedPages;
+		}
+		return !SlowTask.ShouldCancel();
+	});
+
+	// LZꂽꍇ͎c̃t@CC|[gȂ
+	// TlC̍쐬ۑɃLZꂽꍇ͕ۑς݂̃pbP[WcȂ
+	if (SlowTask.ShouldCancel())
 	{
+		if (LoadedPDF != nullptr)
+		{
+			GhostscriptCore->DiscardPdfAsset(LoadedPDF);
+		}
 		bOutOperationCanceled = true;
 		return nullptr;
 	}
+
+	UPDF* NewPDF = CastChecked<UPDF>(StaticConstructObject_Internal(InClass, InParent, InName, Flags));
+	if (LoadedPDF != nullptr)
+	{
+		NewPDF->PageRange = LoadedPDF->PageRange;
+		NewPDF->Dpi = LoadedPDF->Dpi;
+		NewPDF->Compression = LoadedPDF->Compression;
+		NewPDF->bVirtualTexturePages = LoadedPDF->bVirtualTexturePages;
+		NewPDF->Pages = LoadedPDF->Pages;
+		NewPDF->PageHashes = LoadedPDF->PageHashes;
+		NewPDF->UpdatePageAssets();
+		NewPDF->ThumbnailAtlases = LoadedPDF->ThumbnailAtlases;
+		NewPDF->PageThumbnails = LoadedPDF->PageThumbnails;
+
+		NewPDF->Filename = Filename;
+		NewPDF->TimeStamp = IFileManager::Get().GetTimeStamp(*Filename);
+		NewPDF->AssetImportData = NewObject<UAssetImportData>();
+		NewPDF->AssetImportData->SourceData.Insert({ NewPDF->Filename, NewPDF->TimeStamp });
+	}
+
+	return NewPDF;
+}
+
+void UPDFFactory::CleanUp()
+{
+	Super::CleanUp();
+
+	// ̃C|[gł͍ĂѐݒmF
+	BatchImportOptions = nullptr;
 }
 
 bool UPDFFactory::CanReimport(UObject* Obj, TArray<FString>& OutFilenames)
@@ -116,6 +167,29 @@ EReimportResult::Type UPDFFactory::Reimport(UObject* Obj)
 		return EReimportResult::Failed;
 	}
 
+	// OƓݒŕϊAeςy[W̃eNX`
+	// SẴy[WC|[gĂꍇ̓y[W̑ɒǏ]
+	const bool bIsAllPages = PDF->PageRange.FirstPage == 1 && PDF->PageRange.LastPage == PDF->Pages.Num();
+	const int FirstPage = bIsAllPages ? 0 : PDF->PageRange.FirstPage;
+	const int LastPage = bIsAllPages ? 0 : PDF->PageRange.LastPage;
+
+	TArray<UTexture2D*> RemovedPages;
+	if (PDF->Pages.Num() > 0 && GhostscriptCore->ReimportPdfAsset(PDF, Filename, PDF->Dpi, FirstPage, LastPage, RemovedPages))
+	{
+		if (RemovedPages.Num() > 0)
+		{
+			TArray<UObject*> AssetsToDelete(RemovedPages);
+			ObjectTools::ForceDeleteObjects(AssetsToDelete, false);
+		}
+
+		PDF->Filename = Filename;
+		PDF->TimeStamp = IFileManager::Get().GetTimeStamp(*Filename);
+		PDF->AssetImportData->Update(Filename);
+		PDF->MarkPackageDirty();
+
+		return EReimportResult::Succeeded;
+	}
+
 	// Ây[W̃eNX`AZbg폜
 	if(!DeletePageTextures(PDF))
 	{
@@ -192,12 +266,24 @@ bool UPDFFactory::DeletePageTextures(UPDF* PdfToDelete)
 {
 	if (PdfToDelete->Pages.Num() != 0)
 	{
+		// ǂݍ܂ĂȂy[W폜
+		PdfToDelete->LoadAllPages();
+
 		TArray<UObject*> AssetsToDelete;
 		for (auto Page : PdfToDelete->Pages)
 		{
 			AssetsToDelete.Add(Cast<UObject>(Page));
 		}
 
+		// TlC̃AgXfBNg̃pbP[Wɂ
+		for (auto Atlas : PdfToDelete->ThumbnailAtlases)
+		{
+			if (Atlas != nullptr)
+			{
+				AssetsToDelete.Add(Atlas);
+			}
+		}
+
 		return ObjectTools::ForceDeleteObjects(AssetsToDelete, false) == AssetsToDelete.Num();
 	}
 
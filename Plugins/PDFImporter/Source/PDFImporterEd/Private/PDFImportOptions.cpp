@@ -18,6 +18,7 @@
 SPDFImportOptions::SPDFImportOptions()
 	: ImportOptions(nullptr)
 	, bShouldImport(false)
+	, bShouldImportAll(false)
 {
 }
 
@@ -90,6 +91,15 @@ void SPDFImportOptions::Construct(const FArguments& InArgs)
 					]
 
 				+ SUniformGridPanel::Slot(1, 0)
+					[
+						SNew(SButton)
+						.HAlign(HAlign_Center)
+						.Text(LOCTEXT("PDFImportOptions_ImportAll", "Import All"))
+						.ToolTipText(LOCTEXT("PDFImportOptions_ImportAll_ToolTip", "Imports all the selected PDF files with these options"))
+						.OnClicked(this, &SPDFImportOptions::OnImportAll)
+					]
+
+				+ SUniformGridPanel::Slot(2, 0)
 					[
 						SNew(SButton)
 						.HAlign(HAlign_Center)
@@ -118,6 +128,12 @@ FReply SPDFImportOptions::OnImport()
 	return FReply::Handled();
 }
 
+FReply SPDFImportOptions::OnImportAll()
+{
+	bShouldImportAll = true;
+	return OnImport();
+}
+
 FReply SPDFImportOptions::OnCancel()
 {
 	bShouldImport = false;
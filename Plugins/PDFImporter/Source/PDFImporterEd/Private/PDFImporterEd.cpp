@@ -4,6 +4,11 @@
 #include "AssetTypeActions_PDF.h"
 #include "SlateStyle.h"
 #include "IPluginManager.h"
+#include "ISettingsModule.h"
+#include "PDFImporterSettings.h"
+#include "PDF.h"
+#include "PDFThumbnailRenderer.h"
+#include "ThumbnailRendering/ThumbnailManager.h"
 
 #define LOCTEXT_NAMESPACE "FPDFImporterModuleEd"
 
@@ -23,10 +28,35 @@ void FPDFImporterEdModule::StartupModule()
 		StyleSet->Set(TEXT("ClassThumbnail.PDF"), ThumbnailBrush);
 		FSlateStyleRegistry::RegisterSlateStyle(*StyleSet);
 	}
+
+	// y[W̃pbP[Wǂݍ܂ɃTlC\郌_[o^
+	UThumbnailManager::Get().RegisterCustomRenderer(UPDF::StaticClass(), UPDFThumbnailRenderer::StaticClass());
+
+	// vWFNgݒPDF̕ϊݒo^
+	ISettingsModule* SettingsModule = FModuleManager::GetModulePtr<ISettingsModule>("Settings");
+	if (SettingsModule != nullptr)
+	{
+		SettingsModule->RegisterSettings("Project", "Plugins", "PDFImporter",
+			LOCTEXT("PDFImporterSettingsName", "PDF Importer"),
+			LOCTEXT("PDFImporterSettingsDescription", "Configure how PDF files are converted."),
+			GetMutableDefault<UPDFImporterSettings>()
+		);
+	}
 }
 
 void FPDFImporterEdModule::ShutdownModule()
 {
+	if (UObjectInitialized())
+	{
+		UThumbnailManager::Get().UnregisterCustomRenderer(UPDF::StaticClass());
+	}
+
+	ISettingsModule* SettingsModule = FModuleManager::GetModulePtr<ISettingsModule>("Settings");
+	if (SettingsModule != nullptr)
+	{
+		SettingsModule->UnregisterSettings("Project", "Plugins", "PDFImporter");
+	}
+
 	if (PDF_AssetTypeActions.IsValid())
 	{
 		if (FModuleManager::Get().IsModuleLoaded(TEXT("AssetTools")))
@@ -0,0 +1,66 @@
+#include "PDFThumbnailRenderer.h"
+#include "PDF.h"
+#include "Engine/Texture2D.h"
+#include "CanvasItem.h"
+#include "CanvasTypes.h"
+
+// 最初のページのアトラス上の範囲と大きさをピクセルで取得する
+static bool GetFirstPageThumbnail(UPDF* PDF, UTexture2D*& OutAtlas, FVector2D& OutUVOffset, FVector2D& OutUVSize, FVector2D& OutSize)
+{
+	if (PDF == nullptr || !PDF->GetPageThumbnail(1, OutAtlas, OutUVOffset, OutUVSize))
+	{
+		return false;
+	}
+
+	OutSize = FVector2D(OutUVSize.X * OutAtlas->GetSurfaceWidth(), OutUVSize.Y * OutAtlas->GetSurfaceHeight());
+	return OutSize.X > 0.f && OutSize.Y > 0.f;
+}
+
+bool UPDFThumbnailRenderer::CanVisualizeAsset(UObject* Object)
+{
+	// サムネイルのアトラスがない古いアセットはクラスのアイコンを表示する
+	UTexture2D* Atlas = nullptr;
+	FVector2D UVOffset;
+	FVector2D UVSize;
+	FVector2D ThumbnailSize;
+	return GetFirstPageThumbnail(Cast<UPDF>(Object), Atlas, UVOffset, UVSize, ThumbnailSize);
+}
+
+void UPDFThumbnailRenderer::GetThumbnailSize(UObject* Object, float Zoom, uint32& OutWidth, uint32& OutHeight) const
+{
+	UTexture2D* Atlas = nullptr;
+	FVector2D UVOffset;
+	FVector2D UVSize;
+	FVector2D ThumbnailSize;
+	if (GetFirstPageThumbnail(Cast<UPDF>(Object), Atlas, UVOffset, UVSize, ThumbnailSize))
+	{
+		OutWidth = FMath::TruncToInt(Zoom * ThumbnailSize.X);
+		OutHeight = FMath::TruncToInt(Zoom * ThumbnailSize.Y);
+	}
+	else
+	{
+		OutWidth = 0;
+		OutHeight = 0;
+	}
+}
+
+void UPDFThumbnailRenderer::Draw(UObject* Object, int32 X, int32 Y, uint32 Width, uint32 Height, FRenderTarget* Viewport, FCanvas* Canvas)
+{
+	UTexture2D* Atlas = nullptr;
+	FVector2D UVOffset;
+	FVector2D UVSize;
+	FVector2D ThumbnailSize;
+	if (!GetFirstPageThumbnail(Cast<UPDF>(Object), Atlas, UVOffset, UVSize, ThumbnailSize) || Atlas->Resource == nullptr)
+	{
+		return;
+	}
+
+	// アトラスの最初のページの部分だけを縦横比を保ったまま中央に描画する
+	const float Scale = FMath::Min(Width / ThumbnailSize.X, Height / ThumbnailSize.Y);
+	const FVector2D Size = ThumbnailSize * Scale;
+	const FVector2D Position(X + (Width - Size.X) * 0.5f, Y + (Height - Size.Y) * 0.5f);
+
+	FCanvasTileItem TileItem(Position, Atlas->Resource, Size, UVOffset, UVOffset + UVSize, FLinearColor::White);
+	TileItem.BlendMode = SE_BLEND_Opaque;
+	Canvas->DrawItem(TileItem);
+}
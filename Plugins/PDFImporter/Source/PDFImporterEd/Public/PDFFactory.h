@@ -13,6 +13,10 @@ class PDFIMPORTERED_API UPDFFactory : public UFactory, public FReimportHandler
 private:
 	TSharedPtr<class FGhostscriptCore> GhostscriptCore;
 
+	// Options chosen with "Import All", reused for the remaining files of the same import
+	UPROPERTY(Transient)
+	class UPDFImportOptions* BatchImportOptions;
+
 public:
 	// UFactory interface
 	virtual bool DoesSupportClass(UClass* Class) override;
@@ -27,6 +31,7 @@ public:
 		FFeedbackContext* Warn,
 		bool& bOutOperationCanceled
 	)override;
+	virtual void CleanUp() override;
 	// End of UFactory interface
 
 	// FReimportHandler interface
@@ -6,6 +6,7 @@
 #include "UObject/NoExportTypes.h"
 #include "Widgets/SWindow.h"
 #include "Widgets/SCompoundWidget.h"
+#include "PDF.h"
 #include "PDFImportOptions.generated.h"
 
 UCLASS()
@@ -26,8 +27,11 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Dpi")
 	int Dpi;
 
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Texture")
+	EPDFPageCompression Compression;
+
 public:
-	UPDFImportOptions() : SpecifyPageRange(false), FirstPage(1), LastPage(1), Dpi(150) {}
+	UPDFImportOptions() : SpecifyPageRange(false), FirstPage(1), LastPage(1), Dpi(150), Compression(EPDFPageCompression::Uncompressed) {}
 };
 
 class SPDFImportOptions : public SCompoundWidget
@@ -35,6 +39,7 @@ class SPDFImportOptions : public SCompoundWidget
 private:
 	UPDFImportOptions* ImportOptions;
 	bool bShouldImport;
+	bool bShouldImportAll;
 	TWeakPtr<class SWindow> WidgetWindow;
 	TSharedPtr<class IDetailsView> DetailsView;
 
@@ -56,10 +61,14 @@ public:
 
 	// Button reaction
 	FReply OnImport();
+	FReply OnImportAll();
 	FReply OnCancel();
 	// End of Button reaction
 
 	// Import was done
 	bool ShouldImport() const { return bShouldImport; }
+
+	// The same options are used for the remaining files
+	bool ShouldImportAll() const { return bShouldImportAll; }
 };
 
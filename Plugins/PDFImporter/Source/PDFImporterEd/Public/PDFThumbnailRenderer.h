@@ -0,0 +1,19 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ThumbnailRendering/ThumbnailRenderer.h"
+#include "PDFThumbnailRenderer.generated.h"
+
+// Draws the first page from the thumbnail atlases, which live in their own package, so that browsing PDFs does not load any page package
+UCLASS()
+class PDFIMPORTERED_API UPDFThumbnailRenderer : public UThumbnailRenderer
+{
+	GENERATED_BODY()
+
+public:
+	// UThumbnailRenderer interface
+	virtual bool CanVisualizeAsset(UObject* Object) override;
+	virtual void GetThumbnailSize(UObject* Object, float Zoom, uint32& OutWidth, uint32& OutHeight) const override;
+	virtual void Draw(UObject* Object, int32 X, int32 Y, uint32 Width, uint32 Height, FRenderTarget* Viewport, FCanvas* Canvas) override;
+	// End of UThumbnailRenderer interface
+};
@@ -74,4 +74,38 @@ public:
 	/** If true, displays a border around the texture. */
 	UPROPERTY(config)
 	bool TextureBorderEnabled;
+
+public:
+
+	/** If true, zoomed pages are rendered again in tiles at the resolution of the current zoom so that text stays sharp. */
+	UPROPERTY(config, EditAnywhere, Category=TiledRendering)
+	bool TiledRenderingEnabled;
+
+	/** The width and height of the tiles in pixels. */
+	UPROPERTY(config, EditAnywhere, Category=TiledRendering, meta=(ClampMin="128", ClampMax="1024", EditCondition="TiledRenderingEnabled"))
+	int32 TileSize;
+
+public:
+
+	/** If true, all pages are laid out in a vertical strip that scrolls continuously. */
+	UPROPERTY(config)
+	bool ContinuousScrollEnabled;
+
+	/** The gap between the pages in the continuous scroll mode in pixels. */
+	UPROPERTY(config, EditAnywhere, Category=ContinuousScroll, meta=(ClampMin="0", ClampMax="256"))
+	int32 PageSpacing;
+
+	/** The number of pages ahead in the scroll direction that are rendered or streamed in before they become visible. */
+	UPROPERTY(config, EditAnywhere, Category=ContinuousScroll, meta=(ClampMin="0", ClampMax="16"))
+	int32 ScrollPrefetchPages;
+
+public:
+
+	/** The number of pages ahead in the navigation direction that are rendered or streamed in after each page turn. Scrolling through the pages uses ScrollPrefetchPages instead. */
+	UPROPERTY(config, EditAnywhere, Category=Prefetch, meta=(ClampMin="0", ClampMax="16"))
+	int32 NavigationPrefetchPages;
+
+	/** The pages the user turns to in this many seconds at the current speed are prefetched in addition to NavigationPrefetchPages. */
+	UPROPERTY(config, EditAnywhere, Category=Prefetch, meta=(ClampMin="0.0", ClampMax="10.0"))
+	float PrefetchLookaheadSeconds;
 };
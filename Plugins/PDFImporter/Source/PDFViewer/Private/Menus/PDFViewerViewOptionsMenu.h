@@ -53,6 +53,7 @@ public:
 
 			MenuBuilder.AddMenuEntry(FPDFViewerCommands::Get().TextureBorder);
 			MenuBuilder.AddMenuEntry(FPDFViewerCommands::Get().FitToViewport);
+			MenuBuilder.AddMenuEntry(FPDFViewerCommands::Get().ContinuousScroll);
 		}
 		MenuBuilder.EndSection();
 
@@ -0,0 +1,116 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "Models/PDFPagePrefetcher.h"
+#include "Engine/Texture2D.h"
+#include "HAL/PlatformTime.h"
+#include "PDF.h"
+#include "PDFViewerSettings.h"
+
+
+/** Page changes further apart than this start a new navigation, so that its speed isn't mixed with the last one */
+static const double NavigationTimeout = 2.0;
+
+/** The weight of the latest page change in the smoothed navigation speed */
+static const float VelocitySmoothing = 0.5f;
+
+/** The most pages prefetched ahead however fast the user navigates, to keep the page cache from thrashing */
+static const int32 MaxPrefetchPages = 32;
+
+
+/* FPDFPagePrefetcher structors
+ *****************************************************************************/
+
+FPDFPagePrefetcher::FPDFPagePrefetcher( )
+	: LastChangeTime(0.0)
+	, Velocity(0.0f)
+	, NumHits(0)
+	, NumMisses(0)
+{ }
+
+
+/* FPDFPagePrefetcher interface
+ *****************************************************************************/
+
+void FPDFPagePrefetcher::RecordPageChange( UPDF* PDF, int32 PreviousPage, int32 NewPage )
+{
+	if (PDF == nullptr || NewPage == PreviousPage)
+	{
+		return;
+	}
+
+	if (IsPageReady(PDF, NewPage))
+	{
+		NumHits++;
+	}
+	else
+	{
+		NumMisses++;
+	}
+
+	// Jumps count as a single step, so that entering a far page only sets the direction
+	const double CurrentTime = FPlatformTime::Seconds();
+	const double ElapsedTime = FMath::Max(CurrentTime - LastChangeTime, 0.05);
+	const float Step = (NewPage > PreviousPage) ? 1.0f : -1.0f;
+	const float CurrentVelocity = (float)(Step / ElapsedTime);
+
+	if (ElapsedTime > NavigationTimeout || FMath::Sign(CurrentVelocity) != FMath::Sign(Velocity))
+	{
+		Velocity = CurrentVelocity;
+	}
+	else
+	{
+		Velocity = FMath::Lerp(Velocity, CurrentVelocity, VelocitySmoothing);
+	}
+
+	LastChangeTime = CurrentTime;
+}
+
+
+void FPDFPagePrefetcher::PrefetchAhead( UPDF* PDF, int32 Page )
+{
+	if (PDF == nullptr)
+	{
+		return;
+	}
+
+	// Look further ahead the faster the user navigates
+	const UPDFViewerSettings& Settings = *GetDefault<UPDFViewerSettings>();
+	const int32 NumPages = FMath::Min(Settings.NavigationPrefetchPages + FMath::FloorToInt(FMath::Abs(Velocity) * Settings.PrefetchLookaheadSeconds), MaxPrefetchPages);
+
+	if (NumPages <= 0)
+	{
+		return;
+	}
+
+	const int32 FirstPage = FMath::Max((Velocity >= 0.0f) ? Page + 1 : Page - NumPages, 1);
+	const int32 LastPage = FMath::Min((Velocity >= 0.0f) ? Page + NumPages : Page - 1, PDF->GetPageCount());
+
+	if (FirstPage > LastPage)
+	{
+		return;
+	}
+
+	PDF->PrefetchPages(FirstPage, LastPage);
+
+	if (!PDF->bRenderPagesOnDemand)
+	{
+		for (int32 PrefetchPage = FirstPage; PrefetchPage <= LastPage; PrefetchPage++)
+		{
+			if (UTexture2D* PageTexture = PDF->FindPageTexture(PrefetchPage))
+			{
+				PageTexture->SetForceMipLevelsToBeResident(30.0f);
+			}
+		}
+	}
+}
+
+
+/* FPDFPagePrefetcher implementation
+ *****************************************************************************/
+
+bool FPDFPagePrefetcher::IsPageReady( UPDF* PDF, int32 Page )
+{
+	UTexture2D* PageTexture = PDF->FindPageTexture(Page);
+
+	return PageTexture != nullptr && PageTexture->IsFullyStreamedIn();
+}
@@ -0,0 +1,65 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UPDF;
+
+/**
+ * Warms the pages the user is likely to turn to next.
+ *
+ * The prefetcher follows the direction and speed of the navigation, so that flipping through a document
+ * fast prefetches further ahead. Pages of PDFs rendered on demand are rendered in the background, page
+ * assets that are not loaded yet are loaded in the background, and the mips of loaded pages are requested
+ * from the texture streamer.
+ */
+class FPDFPagePrefetcher
+{
+public:
+	/** Constructor */
+	FPDFPagePrefetcher();
+
+	/**
+	 * Records a page change, call it before the new page is loaded.
+	 *
+	 * @param PDF The PDF asset being viewed.
+	 * @param PreviousPage The number of the page shown before, starting at 1.
+	 * @param NewPage The number of the page shown now, starting at 1.
+	 */
+	void RecordPageChange(UPDF* PDF, int32 PreviousPage, int32 NewPage);
+
+	/**
+	 * Prefetches the pages ahead of a page in the navigation direction.
+	 *
+	 * @param PDF The PDF asset being viewed.
+	 * @param Page The number of the page shown now, starting at 1.
+	 */
+	void PrefetchAhead(UPDF* PDF, int32 Page);
+
+	/** Returns the number of page changes that found the new page ready */
+	int32 GetNumHits() const { return NumHits; }
+
+	/** Returns the number of page changes that had to wait for the new page */
+	int32 GetNumMisses() const { return NumMisses; }
+
+	/** Returns the recent navigation speed in pages per second, negative while going back */
+	float GetVelocity() const { return Velocity; }
+
+private:
+	/** Returns whether a page is rendered and fully streamed in */
+	static bool IsPageReady(UPDF* PDF, int32 Page);
+
+private:
+	/** The time of the last page change in seconds */
+	double LastChangeTime;
+
+	/** The smoothed navigation speed in pages per second, negative while going back */
+	float Velocity;
+
+	/** The number of page changes that found the new page ready */
+	int32 NumHits;
+
+	/** The number of page changes that had to wait for the new page */
+	int32 NumMisses;
+};
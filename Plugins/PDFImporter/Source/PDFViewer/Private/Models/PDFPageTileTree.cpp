@@ -0,0 +1,367 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "Models/PDFPageTileTree.h"
+#include "Async/Async.h"
+#include "CanvasItem.h"
+#include "CanvasTypes.h"
+#include "Engine/Texture2D.h"
+#include "Modules/ModuleManager.h"
+#include "PDF.h"
+#include "PDFImporter.h"
+#include "PDFImporterSettings.h"
+#include "GhostscriptCore.h"
+#include "PDFViewerSettings.h"
+#include "Runtime/Launch/Resources/Version.h"
+
+
+/** The deepest level of the quadtree, enough for the maximum zoom of the viewer */
+static const int32 MaxTileLevel = 5;
+
+/** The coarsest level of the quadtree, for pages that are drawn from tiles only */
+static const int32 MinTileLevel = -4;
+
+/** The number of screens of tiles kept for panning and zooming back */
+static const int32 NumCachedScreens = 2;
+
+
+/* FPDFPageTileTree structors
+ *****************************************************************************/
+
+FPDFPageTileTree::FPDFPageTileTree( UPDF* InPDF, int32 InPageIndex )
+	: PDF(InPDF)
+	, PageIndex(InPageIndex)
+	, PageSizeInPoints(FVector2D::ZeroVector)
+	, bPageSizeRequested(false)
+	, bIsPageSizePending(false)
+	, TileSize(GetDefault<UPDFViewerSettings>()->TileSize)
+	, NumRenderingTiles(0)
+	, FrameNumber(0)
+{
+	check(PDF != nullptr);
+}
+
+
+FPDFPageTileTree::~FPDFPageTileTree( )
+{
+	for (const TPair<FIntVector, FTile>& Tile : Tiles)
+	{
+		DestroyTileTexture(Tile.Value.Texture);
+	}
+}
+
+
+/* FPDFPageTileTree interface
+ *****************************************************************************/
+
+void FPDFPageTileTree::Draw( FCanvas* Canvas, UTexture2D* PageTexture, const FVector2D& PagePosition, const FVector2D& PageSize, const FVector2D& ViewportSize, const FLinearColor& Color, ESimpleElementBlendMode BlendMode )
+{
+	FrameNumber++;
+
+	// The tiles are placed from the size of the page in points, so get it first
+	if (!bPageSizeRequested)
+	{
+		bPageSizeRequested = true;
+		bIsPageSizePending = true;
+
+		FPDFImporterModule& PDFImporterModule = FModuleManager::LoadModuleChecked<FPDFImporterModule>(FName("PDFImporter"));
+		TSharedPtr<FGhostscriptCore> GhostscriptCore = PDFImporterModule.GetGhostscriptCore();
+		TWeakPtr<FPDFPageTileTree> WeakThis = AsShared();
+		const FString InputPath = PDF->Filename;
+		const int32 PageNumber = FMath::Max(PDF->PageRange.FirstPage, 1) + PageIndex;
+
+		GhostscriptCore->StartRenderTask([GhostscriptCore, WeakThis, InputPath, PageNumber]()
+		{
+			FVector2D Size = FVector2D::ZeroVector;
+			GhostscriptCore->GetPageSize(InputPath, PageNumber, Size);
+
+			AsyncTask(ENamedThreads::GameThread, [WeakThis, Size]()
+			{
+				if (TSharedPtr<FPDFPageTileTree> This = WeakThis.Pin())
+				{
+					This->PageSizeInPoints = Size;
+					This->bIsPageSizePending = false;
+				}
+			});
+		});
+	}
+
+	if (PageSizeInPoints.X <= 0.0f || PageSizeInPoints.Y <= 0.0f || PageSize.X <= 0.0f || PageSize.Y <= 0.0f || PDF->Dpi <= 0)
+	{
+		return;
+	}
+
+	// The page texture is enough as long as it is at least as sharp as the displayed page
+	const float DisplayedDpi = PageSize.X / PageSizeInPoints.X * 72.0f;
+	if (PageTexture != nullptr && !IsVirtualTexture(PageTexture))
+	{
+		const float TextureDpi = PageTexture->GetSizeX() / PageSizeInPoints.X * 72.0f;
+		if (DisplayedDpi <= TextureDpi * 1.01f)
+		{
+			return;
+		}
+	}
+
+	// Use the first level at least as sharp as the displayed page
+	const int32 Level = FMath::Clamp(FMath::CeilToInt(FMath::Log2(DisplayedDpi / PDF->Dpi)), MinTileLevel, MaxTileLevel);
+
+	// Find the tiles that intersect the viewport
+	const FIntPoint LevelSize = GetLevelSize(Level);
+	const FVector2D Scale = FVector2D(LevelSize) / PageSize;
+	const FVector2D VisibleMin = FVector2D::Max(-PagePosition, FVector2D::ZeroVector) * Scale;
+	const FVector2D VisibleMax = FVector2D::Min(ViewportSize - PagePosition, PageSize) * Scale;
+	if (VisibleMax.X <= VisibleMin.X || VisibleMax.Y <= VisibleMin.Y)
+	{
+		return;
+	}
+
+	const int32 MinX = FMath::FloorToInt(VisibleMin.X / TileSize);
+	const int32 MinY = FMath::FloorToInt(VisibleMin.Y / TileSize);
+	const int32 MaxX = FMath::Min(FMath::CeilToInt(VisibleMax.X / TileSize), FMath::DivideAndRoundUp(LevelSize.X, TileSize)) - 1;
+	const int32 MaxY = FMath::Min(FMath::CeilToInt(VisibleMax.Y / TileSize), FMath::DivideAndRoundUp(LevelSize.Y, TileSize)) - 1;
+
+	TArray<FIntVector> VisibleTiles;
+	for (int32 Y = MinY; Y <= MaxY; Y++)
+	{
+		for (int32 X = MinX; X <= MaxX; X++)
+		{
+			VisibleTiles.Add(FIntVector(X, Y, Level));
+		}
+	}
+
+	// Render the tiles in the middle of the viewport first
+	const FVector2D Center = (VisibleMin + VisibleMax) * 0.5f / TileSize;
+	VisibleTiles.Sort([&Center](const FIntVector& A, const FIntVector& B)
+	{
+		return FVector2D::DistSquared(FVector2D(A.X + 0.5f, A.Y + 0.5f), Center) < FVector2D::DistSquared(FVector2D(B.X + 0.5f, B.Y + 0.5f), Center);
+	});
+
+	for (const FIntVector& Key : VisibleTiles)
+	{
+		const FIntRect TileRegion = GetTileRegion(Key);
+		const FBox2D Region(FVector2D(TileRegion.Min), FVector2D(TileRegion.Max));
+
+		FTile* Tile = Tiles.Find(Key);
+		if (Tile == nullptr)
+		{
+			RequestTile(Key);
+		}
+		else
+		{
+			Tile->LastDrawnFrame = FrameNumber;
+
+			if (Tile->Texture != nullptr)
+			{
+				DrawTile(Canvas, Key, Region, PagePosition, PageSize, Color, BlendMode);
+				continue;
+			}
+		}
+
+		// Until the tile arrives, draw the part of the nearest rendered tile above it in the tree
+		for (int32 ParentLevel = Level - 1; ParentLevel >= MinTileLevel; ParentLevel--)
+		{
+			const FVector2D ParentScale = FVector2D(GetLevelSize(ParentLevel)) / FVector2D(LevelSize);
+			const FBox2D ParentRegion(Region.Min * ParentScale, Region.Max * ParentScale);
+			const FIntVector ParentKey(FMath::FloorToInt(ParentRegion.Min.X / TileSize), FMath::FloorToInt(ParentRegion.Min.Y / TileSize), ParentLevel);
+
+			FTile* Parent = Tiles.Find(ParentKey);
+			if (Parent != nullptr && Parent->Texture != nullptr)
+			{
+				Parent->LastDrawnFrame = FrameNumber;
+				DrawTile(Canvas, ParentKey, ParentRegion, PagePosition, PageSize, Color, BlendMode);
+				break;
+			}
+		}
+	}
+
+	// Keep as many tiles as cover the viewport a few times over, regardless of the page resolution
+	const float DisplayedTileSize = TileSize / Scale.X;
+	const int32 NumTilesPerScreen = (FMath::CeilToInt(ViewportSize.X / DisplayedTileSize) + 1) * (FMath::CeilToInt(ViewportSize.Y / DisplayedTileSize) + 1);
+	ReleaseTiles(NumTilesPerScreen * NumCachedScreens);
+}
+
+
+void FPDFPageTileTree::AddReferencedObjects( FReferenceCollector& Collector )
+{
+	Collector.AddReferencedObject(PDF);
+
+	for (TPair<FIntVector, FTile>& Tile : Tiles)
+	{
+		Collector.AddReferencedObject(Tile.Value.Texture);
+	}
+}
+
+
+/* FPDFPageTileTree implementation
+ *****************************************************************************/
+
+int32 FPDFPageTileTree::GetLevelDpi( int32 Level ) const
+{
+	return (Level >= 0) ? (PDF->Dpi << Level) : FMath::Max(PDF->Dpi >> -Level, 1);
+}
+
+
+FIntPoint FPDFPageTileTree::GetLevelSize( int32 Level ) const
+{
+	const float PixelsPerPoint = GetLevelDpi(Level) / 72.0f;
+	return FIntPoint(FMath::CeilToInt(PageSizeInPoints.X * PixelsPerPoint), FMath::CeilToInt(PageSizeInPoints.Y * PixelsPerPoint));
+}
+
+
+FIntRect FPDFPageTileTree::GetTileRegion( const FIntVector& Key ) const
+{
+	const FIntPoint LevelSize = GetLevelSize(Key.Z);
+	const FIntPoint Min(Key.X * TileSize, Key.Y * TileSize);
+	const FIntPoint Max(FMath::Min(Min.X + TileSize, LevelSize.X), FMath::Min(Min.Y + TileSize, LevelSize.Y));
+
+	return FIntRect(Min, Max);
+}
+
+
+void FPDFPageTileTree::RequestTile( const FIntVector& Key )
+{
+	// Each tile starts a Ghostscript instance, so don't queue more than the render threads can take
+	if (NumRenderingTiles >= GetDefault<UPDFImporterSettings>()->GetNumRenderWorkers())
+	{
+		return;
+	}
+
+	FTile& Tile = Tiles.Add(Key);
+	Tile.bIsRendering = true;
+	Tile.LastDrawnFrame = FrameNumber;
+	NumRenderingTiles++;
+
+	FPDFImporterModule& PDFImporterModule = FModuleManager::LoadModuleChecked<FPDFImporterModule>(FName("PDFImporter"));
+	TSharedPtr<FGhostscriptCore> GhostscriptCore = PDFImporterModule.GetGhostscriptCore();
+	TWeakPtr<FPDFPageTileTree> WeakThis = AsShared();
+	const FString InputPath = PDF->Filename;
+	const int32 PageNumber = FMath::Max(PDF->PageRange.FirstPage, 1) + PageIndex;
+	const int32 Dpi = GetLevelDpi(Key.Z);
+	const FVector2D PageSize = PageSizeInPoints;
+	const FIntRect Region = GetTileRegion(Key);
+
+	// Textures can only be created on the game thread, so only the rendering runs in the background
+	GhostscriptCore->StartRenderTask([GhostscriptCore, WeakThis, InputPath, PageNumber, Dpi, PageSize, Region, Key]()
+	{
+		TSharedRef<FPageBitmap> Bitmap = MakeShared<FPageBitmap>();
+		GhostscriptCore->RenderPageRegion(InputPath, PageNumber, Dpi, PageSize, Region, *Bitmap);
+
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, Key, Bitmap]()
+		{
+			if (TSharedPtr<FPDFPageTileTree> This = WeakThis.Pin())
+			{
+				This->HandleTileRendered(Key, *Bitmap);
+			}
+		});
+	});
+}
+
+
+void FPDFPageTileTree::HandleTileRendered( const FIntVector& Key, const FPageBitmap& Bitmap )
+{
+	NumRenderingTiles--;
+
+	// A tile that failed stays empty so that it isn't requested over and over, its parent is drawn instead
+	FTile* Tile = Tiles.Find(Key);
+	if (Tile == nullptr)
+	{
+		return;
+	}
+
+	Tile->bIsRendering = false;
+	if (Bitmap.Pixels.Num() == 0)
+	{
+		return;
+	}
+
+	UTexture2D* Texture = UTexture2D::CreateTransient(Bitmap.Width, Bitmap.Height, PF_B8G8R8A8);
+	if (Texture == nullptr)
+	{
+		return;
+	}
+
+	// Clamp so that the edges of neighboring tiles don't bleed into each other
+	Texture->AddressX = TA_Clamp;
+	Texture->AddressY = TA_Clamp;
+
+	void* TextureData = Texture->PlatformData->Mips[0].BulkData.Lock(LOCK_READ_WRITE);
+	FMemory::Memcpy(TextureData, Bitmap.Pixels.GetData(), Bitmap.Pixels.Num());
+	Texture->PlatformData->Mips[0].BulkData.Unlock();
+	Texture->UpdateResource();
+
+	Tile->Texture = Texture;
+}
+
+
+void FPDFPageTileTree::DrawTile( FCanvas* Canvas, const FIntVector& Key, const FBox2D& Region, const FVector2D& PagePosition, const FVector2D& PageSize, const FLinearColor& Color, ESimpleElementBlendMode BlendMode )
+{
+	UTexture2D* Texture = Tiles.FindChecked(Key).Texture;
+	if (Texture == nullptr || Texture->Resource == nullptr)
+	{
+		return;
+	}
+
+	// Snap to whole pixels so that there are no gaps between the tiles
+	const FVector2D Scale = PageSize / FVector2D(GetLevelSize(Key.Z));
+	const FVector2D Min(FMath::RoundToFloat(PagePosition.X + Region.Min.X * Scale.X), FMath::RoundToFloat(PagePosition.Y + Region.Min.Y * Scale.Y));
+	const FVector2D Max(FMath::RoundToFloat(PagePosition.X + Region.Max.X * Scale.X), FMath::RoundToFloat(PagePosition.Y + Region.Max.Y * Scale.Y));
+
+	const FVector2D TileOrigin(GetTileRegion(Key).Min);
+	const FVector2D TextureSize(Texture->GetSizeX(), Texture->GetSizeY());
+
+	FCanvasTileItem TileItem(Min, Texture->Resource, Max - Min, (Region.Min - TileOrigin) / TextureSize, (Region.Max - TileOrigin) / TextureSize, Color);
+	TileItem.BlendMode = BlendMode;
+	Canvas->DrawItem(TileItem);
+}
+
+
+void FPDFPageTileTree::ReleaseTiles( int32 MaxTiles )
+{
+	if (Tiles.Num() <= MaxTiles)
+	{
+		return;
+	}
+
+	// Tiles drawn this frame and tiles still being rendered are never released
+	TArray<FIntVector> ReleasableTiles;
+	for (const TPair<FIntVector, FTile>& Tile : Tiles)
+	{
+		if (Tile.Value.LastDrawnFrame != FrameNumber && !Tile.Value.bIsRendering)
+		{
+			ReleasableTiles.Add(Tile.Key);
+		}
+	}
+
+	ReleasableTiles.Sort([this](const FIntVector& A, const FIntVector& B)
+	{
+		return Tiles[A].LastDrawnFrame < Tiles[B].LastDrawnFrame;
+	});
+
+	for (int32 Index = 0; Index < ReleasableTiles.Num() && Tiles.Num() > MaxTiles; Index++)
+	{
+		DestroyTileTexture(Tiles[ReleasableTiles[Index]].Texture);
+		Tiles.Remove(ReleasableTiles[Index]);
+	}
+}
+
+
+bool FPDFPageTileTree::IsVirtualTexture( const UTexture2D* Texture )
+{
+#if ENGINE_MINOR_VERSION >= 23
+	return Texture->IsCurrentlyVirtualTextured();
+#else
+	return false;
+#endif
+}
+
+
+void FPDFPageTileTree::DestroyTileTexture( UTexture2D* Texture )
+{
+	if (Texture)
+	{
+		if (Texture->Resource)
+		{
+			Texture->ReleaseResource();
+		}
+		Texture->MarkPendingKill();
+	}
+}
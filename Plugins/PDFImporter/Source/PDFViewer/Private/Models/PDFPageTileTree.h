@@ -0,0 +1,137 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/GCObject.h"
+#include "BatchedElements.h"
+
+class FCanvas;
+class UPDF;
+class UTexture2D;
+struct FPageBitmap;
+
+/**
+ * Renders a page again in tiles at the resolution the current zoom needs.
+ *
+ * The tiles form a quadtree over the page. Level 0 has the resolution of the import DPI, and every
+ * following level doubles it, so that each tile covers four tiles of the next level. Levels below 0 are
+ * only used for pages whose texture can't be drawn or was shrunk to fit the maximum texture size.
+ * Only the tiles in the viewport are rendered, and the number of cached tiles follows the viewport size.
+ */
+class FPDFPageTileTree
+	: public TSharedFromThis<FPDFPageTileTree>
+	, public FGCObject
+{
+public:
+	/** Constructor */
+	FPDFPageTileTree(UPDF* InPDF, int32 InPageIndex);
+	~FPDFPageTileTree();
+
+	/**
+	 * Draws the tiles that cover the visible part of the page and requests the missing ones.
+	 *
+	 * Nothing is drawn where the page texture is sharp enough. Pages stored as virtual textures
+	 * can't be drawn on a canvas, so they are drawn from tiles only.
+	 *
+	 * @param Canvas The canvas to draw on.
+	 * @param PageTexture The texture of the page drawn under the tiles.
+	 * @param PagePosition The position of the top left corner of the page in the viewport.
+	 * @param PageSize The displayed size of the page.
+	 * @param ViewportSize The size of the viewport.
+	 * @param Color The color to draw the tiles with.
+	 * @param BlendMode The blend mode to draw the tiles with.
+	 */
+	void Draw(FCanvas* Canvas, UTexture2D* PageTexture, const FVector2D& PagePosition, const FVector2D& PageSize, const FVector2D& ViewportSize, const FLinearColor& Color, ESimpleElementBlendMode BlendMode);
+
+	/** Returns the PDF asset whose page is tiled */
+	UPDF* GetPDF() const { return PDF; }
+
+	/** Returns the index of the tiled page */
+	int32 GetPageIndex() const { return PageIndex; }
+
+	/** Returns the width and height of the tiles in pixels */
+	int32 GetTileSize() const { return TileSize; }
+
+	/** Returns whether the page size or tiles are still being rendered, so that the page must be drawn again when they arrive */
+	bool IsRendering() const { return bIsPageSizePending || NumRenderingTiles > 0; }
+
+	/** Returns whether a page texture streams as a virtual texture */
+	static bool IsVirtualTexture(const UTexture2D* Texture);
+
+	/** FGCObject interface */
+	virtual void AddReferencedObjects(FReferenceCollector& Collector) override;
+
+private:
+	/** A tile of the quadtree, keyed by its column, row and level */
+	struct FTile
+	{
+		FTile() : Texture(nullptr), bIsRendering(false), LastDrawnFrame(0) {}
+
+		/** The rendered tile, nullptr while it is being rendered or if rendering failed */
+		UTexture2D* Texture;
+
+		/** Whether the tile is being rendered in the background */
+		bool bIsRendering;
+
+		/** The frame the tile was last drawn in, used to release the least recently drawn tiles */
+		uint32 LastDrawnFrame;
+	};
+
+	/** Returns the resolution of the tiles of a level */
+	int32 GetLevelDpi(int32 Level) const;
+
+	/** Returns the size of the whole page in pixels at a level */
+	FIntPoint GetLevelSize(int32 Level) const;
+
+	/** Returns the region of the page covered by a tile in pixels of its level */
+	FIntRect GetTileRegion(const FIntVector& Key) const;
+
+	/** Starts rendering a tile in the background */
+	void RequestTile(const FIntVector& Key);
+
+	/** Creates the texture of a rendered tile */
+	void HandleTileRendered(const FIntVector& Key, const FPageBitmap& Bitmap);
+
+	/**
+	 * Draws the part of a rendered tile that covers a region of the page.
+	 *
+	 * @param Key The tile to draw from.
+	 * @param Region The region to draw in pixels of the tile's level.
+	 */
+	void DrawTile(FCanvas* Canvas, const FIntVector& Key, const FBox2D& Region, const FVector2D& PagePosition, const FVector2D& PageSize, const FLinearColor& Color, ESimpleElementBlendMode BlendMode);
+
+	/** Releases the least recently drawn tiles until no more than MaxTiles are left */
+	void ReleaseTiles(int32 MaxTiles);
+
+	/** Releases the texture of a tile */
+	static void DestroyTileTexture(UTexture2D* Texture);
+
+private:
+	/** The PDF asset whose page is tiled */
+	UPDF* PDF;
+
+	/** The index of the tiled page */
+	int32 PageIndex;
+
+	/** The size of the page in points, zero until Ghostscript returns it */
+	FVector2D PageSizeInPoints;
+
+	/** Whether the page size has been requested */
+	bool bPageSizeRequested;
+
+	/** Whether the page size has been requested and not returned yet */
+	bool bIsPageSizePending;
+
+	/** The width and height of the tiles in pixels */
+	int32 TileSize;
+
+	/** The rendered and pending tiles */
+	TMap<FIntVector, FTile> Tiles;
+
+	/** The number of tiles being rendered */
+	int32 NumRenderingTiles;
+
+	/** The number of frames drawn so far */
+	uint32 FrameNumber;
+};
@@ -66,6 +66,9 @@ public:
 	/** If enabled, a border is drawn around the texture */
 	TSharedPtr<FUICommandInfo> TextureBorder;
 
+	/** If enabled, all pages are laid out in a vertical strip that scrolls continuously */
+	TSharedPtr<FUICommandInfo> ContinuousScroll;
+
 	/** To the previous page */
 	TSharedPtr<FUICommandInfo> BackPage;
 
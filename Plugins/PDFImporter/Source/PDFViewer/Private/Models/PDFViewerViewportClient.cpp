@@ -1,6 +1,7 @@
 // Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
 
 #include "Models/PDFViewerViewportClient.h"
+#include "Models/PDFPageTileTree.h"
 #include "Widgets/Layout/SScrollBar.h"
 #include "CanvasItem.h"
 #include "Editor/UnrealEdEngine.h"
@@ -19,6 +20,7 @@
 #include "Widgets/SPDFViewerViewport.h"
 #include "CanvasTypes.h"
 #include "ImageUtils.h"
+#include "PDF.h"
 
 
 /* FPDFViewerViewportClient structors
@@ -28,6 +30,9 @@ FPDFViewerViewportClient::FPDFViewerViewportClient( TWeakPtr<IPDFViewerToolkit>
 	: PDFViewerPtr(InPDFViewer)
 	, PDFViewerViewportPtr(InPDFViewerViewport)
 	, CheckerboardTexture(NULL)
+	, LastScrollPosition(0.0f)
+	, ScrollDirection(1)
+	, bIsWaitingForContent(false)
 {
 	check(PDFViewerPtr.IsValid() && PDFViewerViewportPtr.IsValid());
 
@@ -37,6 +42,11 @@ FPDFViewerViewportClient::FPDFViewerViewportClient( TWeakPtr<IPDFViewerToolkit>
 
 FPDFViewerViewportClient::~FPDFViewerViewportClient( )
 {
+	if (UPDF* PDF = PinnedPDF.Get())
+	{
+		UpdatePinnedPages(PDF, 0, -1);
+	}
+
 	DestroyCheckerboardTexture();
 }
 
@@ -72,15 +82,11 @@ void FPDFViewerViewportClient::Draw(FViewport* Viewport, FCanvas* Canvas)
 	UTextureRenderTarget2D* TextureRT2D = Cast<UTextureRenderTarget2D>(Texture);
 	UTextureRenderTargetCube* RTTextureCube = Cast<UTextureRenderTargetCube>(Texture);
 
-	// Fully stream in the texture before drawing it.
-	if (Texture2D)
-	{
-		Texture2D->SetForceMipLevelsToBeResident(30.0f);
-		Texture2D->WaitForStreaming();
-	}
-
+	// The quick info is only formatted again when the displayed texture changed
 	PDFViewerPtr.Pin()->PopulateQuickInfo();
 
+	bIsWaitingForContent = false;
+
 	// Figure out the size we need
 	uint32 Width, Height;
 	PDFViewerPtr.Pin()->CalculateTextureDimensions(Width, Height);
@@ -121,48 +127,90 @@ void FPDFViewerViewportClient::Draw(FViewport* Viewport, FCanvas* Canvas)
 	//	}
 	//}
 
-	// Draw the background checkerboard pattern in the same size/position as the render texture so it will show up anywhere
-	// the texture has transparency
+	// Draw the background checkerboard pattern behind the entire viewport, the pattern behind each page is drawn with the page
 	if (Settings.Background == PDFViewerBackground_CheckeredFill)
 	{
 		Canvas->DrawTile( 0.0f, 0.0f, Viewport->GetSizeXY().X, Viewport->GetSizeXY().Y, 0.0f, 0.0f, (Viewport->GetSizeXY().X / CheckerboardTexture->GetSizeX()), (Viewport->GetSizeXY().Y / CheckerboardTexture->GetSizeY()), FLinearColor::White, CheckerboardTexture->Resource);
 	}
-	else if (Settings.Background == PDFViewerBackground_Checkered)
-	{
-		Canvas->DrawTile( XPos, YPos, Width, Height, 0.0f, 0.0f, (Width / CheckerboardTexture->GetSizeX()), (Height / CheckerboardTexture->GetSizeY()), FLinearColor::White, CheckerboardTexture->Resource);
-	}
 
 	float Exposure = FMath::Pow(2.0f, (float)PDFViewerViewportPtr.Pin()->GetExposureBias());
+	const FLinearColor Color(Exposure, Exposure, Exposure);
 
-	if ( Texture->Resource != nullptr )
+	UPDF* PDF = PDFViewerPtr.Pin()->GetPDF();
+	if (Settings.ContinuousScrollEnabled && PDF != nullptr && PDF->GetPageCount() > 0)
 	{
-		FCanvasTileItem TileItem( FVector2D( XPos, YPos ), Texture->Resource, FVector2D( Width, Height ), FLinearColor(Exposure, Exposure, Exposure) );
-		TileItem.BlendMode = PDFViewerPtr.Pin()->GetColourChannelBlendMode();
-		//TileItem.BatchedElementParameters = BatchedElementParameters;
-		Canvas->DrawItem( TileItem );
+		DrawContinuousPages(Canvas, PDF, FVector2D(XPos, YPos), FVector2D(Width, Height), ViewportSize, ScrollBarPos.Y, Color);
+	}
+	else
+	{
+		const int32 PageIndex = PDFViewerPtr.Pin()->GetCurrentPage() - 1;
+		UTexture* PageTexture = Texture;
+		if (PDF != nullptr)
+		{
+			UpdatePinnedPages(PDF, PageIndex, PageIndex);
+
+			// A page rendered on demand is drawn from its thumbnail until it arrives from the background,
+			// then the viewer switches to it
+			UTexture2D* RenderedTexture = PDF->FindPageTexture(PageIndex + 1);
+			if (RenderedTexture == nullptr)
+			{
+				PageTexture = nullptr;
+				bIsWaitingForContent |= PDF->IsPagePrefetching(PageIndex + 1);
+			}
+			else if (RenderedTexture != Texture)
+			{
+				PageTexture = RenderedTexture;
+				PDFViewerPtr.Pin()->GoToPage(PageIndex + 1);
+			}
+		}
 
-		// Draw a white border around the texture to show its extents
-		if (Settings.TextureBorderEnabled)
+		// Request the missing mips without waiting for them, the page is drawn from the resident mips or its thumbnail until they arrive
+		if (UTexture2D* PageTexture2D = Cast<UTexture2D>(PageTexture))
 		{
-			FCanvasBoxItem BoxItem( FVector2D(XPos, YPos), FVector2D(Width , Height ) );
-			BoxItem.SetColor( Settings.TextureBorderColor );
-			Canvas->DrawItem( BoxItem );
+			PageTexture2D->SetForceMipLevelsToBeResident(30.0f);
 		}
+
+		DrawPage(Canvas, PageIndex, PageTexture, FVector2D(XPos, YPos), FVector2D(Width, Height), ViewportSize, Color);
+		ReleasePageTiles(PageIndex, PageIndex);
 	}
 }
 
 
 bool FPDFViewerViewportClient::InputKey(FViewport* Viewport, int32 ControllerId, FKey Key, EInputEvent Event, float AmountDepressed, bool Gamepad)
 {
+	// In the continuous scroll mode the wheel scrolls through the pages and zooms while Ctrl is held
+	const bool bScrollPages = GetDefault<UPDFViewerSettings>()->ContinuousScrollEnabled && !Viewport->KeyState(EKeys::LeftControl) && !Viewport->KeyState(EKeys::RightControl);
+	const float ScrollStep = Viewport->GetSizeXY().Y * 0.2f;
+
 	if (Key == EKeys::MouseScrollUp)
 	{
-		PDFViewerPtr.Pin()->ZoomIn();
+		if (bScrollPages)
+		{
+			if (Event == IE_Pressed)
+			{
+				ScrollVertically(-ScrollStep);
+			}
+		}
+		else
+		{
+			PDFViewerPtr.Pin()->ZoomIn();
+		}
 
 		return true;
 	}
 	else if (Key == EKeys::MouseScrollDown)
 	{
-		PDFViewerPtr.Pin()->ZoomOut();
+		if (bScrollPages)
+		{
+			if (Event == IE_Pressed)
+			{
+				ScrollVertically(ScrollStep);
+			}
+		}
+		else
+		{
+			PDFViewerPtr.Pin()->ZoomOut();
+		}
 
 		return true;
 	}
@@ -202,6 +250,12 @@ bool FPDFViewerViewportClient::InputGesture(FViewport* Viewport, EGestureEvent G
 
 	if (GestureType == EGestureEvent::Scroll && !LeftMouseButtonDown && !RightMouseButtonDown)
 	{
+		if (GetDefault<UPDFViewerSettings>()->ContinuousScrollEnabled)
+		{
+			ScrollVertically(-GestureDelta.Y);
+			return true;
+		}
+
 		double CurrentZoom = PDFViewerPtr.Pin()->GetZoom();
 		PDFViewerPtr.Pin()->SetZoom(CurrentZoom + GestureDelta.Y * 0.01);
 		return true;
@@ -242,7 +296,7 @@ float FPDFViewerViewportClient::GetViewportVerticalScrollBarRatio() const
 	float WidgetHeight = 1.0f;
 	if (PDFViewerViewportPtr.Pin()->GetVerticalScrollBar().IsValid())
 	{
-		PDFViewerPtr.Pin()->CalculateTextureDimensions(Width, Height);
+		CalculateContentDimensions(Width, Height);
 
 		WidgetHeight = PDFViewerViewportPtr.Pin()->GetViewport()->GetSizeXY().Y;
 	}
@@ -258,7 +312,7 @@ float FPDFViewerViewportClient::GetViewportHorizontalScrollBarRatio() const
 	float WidgetWidth = 1.0f;
 	if (PDFViewerViewportPtr.Pin()->GetHorizontalScrollBar().IsValid())
 	{
-		PDFViewerPtr.Pin()->CalculateTextureDimensions(Width, Height);
+		CalculateContentDimensions(Width, Height);
 
 		WidgetWidth = PDFViewerViewportPtr.Pin()->GetViewport()->GetSizeXY().X;
 	}
@@ -319,7 +373,7 @@ FVector2D FPDFViewerViewportClient::GetViewportScrollBarPositions() const
 		float VDistFromBottom = PDFViewerViewportPtr.Pin()->GetVerticalScrollBar()->DistanceFromBottom();
 		float HDistFromBottom = PDFViewerViewportPtr.Pin()->GetHorizontalScrollBar()->DistanceFromBottom();
 	
-		PDFViewerPtr.Pin()->CalculateTextureDimensions(Width, Height);
+		CalculateContentDimensions(Width, Height);
 
 		if ((PDFViewerViewportPtr.Pin()->GetVerticalScrollBar()->GetVisibility() == EVisibility::Visible) && VDistFromBottom < 1.0f)
 		{
@@ -343,6 +397,292 @@ FVector2D FPDFViewerViewportClient::GetViewportScrollBarPositions() const
 	return Positions;
 }
 
+void FPDFViewerViewportClient::ScrollToPage(int32 Page)
+{
+	const UPDFViewerSettings& Settings = *GetDefault<UPDFViewerSettings>();
+	TSharedPtr<SPDFViewerViewport> Viewport = PDFViewerViewportPtr.Pin();
+
+	if (!Settings.ContinuousScrollEnabled || !Viewport.IsValid() || !Viewport->GetVerticalScrollBar().IsValid())
+	{
+		return;
+	}
+
+	uint32 Width, Height, ContentWidth, ContentHeight;
+	PDFViewerPtr.Pin()->CalculateTextureDimensions(Width, Height);
+	CalculateContentDimensions(ContentWidth, ContentHeight);
+	float Ratio = GetViewportVerticalScrollBarRatio();
+
+	if (Ratio >= 1.0f || ContentHeight == 0)
+	{
+		return;
+	}
+
+	float PageTop = (float)(Page - 1) * (Height + Settings.PageSpacing);
+	Viewport->GetVerticalScrollBar()->SetState(FMath::Clamp(PageTop / ContentHeight, 0.0f, 1.0f - Ratio), Ratio);
+	Viewport->RequestRedraw();
+
+	// The last pages can't scroll up to the top of the viewport, so the next draw must not take
+	// the page under the top as the current page
+	LastScrollPosition = GetViewportScrollBarPositions().Y;
+}
+
+
+void FPDFViewerViewportClient::DrawPage(FCanvas* Canvas, int32 PageIndex, UTexture* PageTexture, const FVector2D& PagePosition, const FVector2D& PageSize, const FVector2D& ViewportSize, const FLinearColor& Color)
+{
+	const UPDFViewerSettings& Settings = *GetDefault<UPDFViewerSettings>();
+
+	// Draw the background checkerboard pattern in the same size/position as the render texture so it will show up anywhere
+	// the texture has transparency
+	if (Settings.Background == PDFViewerBackground_Checkered)
+	{
+		Canvas->DrawTile( PagePosition.X, PagePosition.Y, PageSize.X, PageSize.Y, 0.0f, 0.0f, (PageSize.X / CheckerboardTexture->GetSizeX()), (PageSize.Y / CheckerboardTexture->GetSizeY()), FLinearColor::White, CheckerboardTexture->Resource);
+	}
+
+	UTexture2D* Texture2D = Cast<UTexture2D>(PageTexture);
+	const ESimpleElementBlendMode BlendMode = PDFViewerPtr.Pin()->GetColourChannelBlendMode();
+	const bool bIsThumbnailDrawn = DrawPageThumbnail(Canvas, PageIndex, Texture2D, PagePosition, PageSize, Color, BlendMode);
+
+	if ( PageTexture != nullptr && PageTexture->Resource != nullptr )
+	{
+		// Draw the page again once the missing mips are streamed in
+		if (Texture2D != nullptr && Texture2D->HasPendingUpdate())
+		{
+			bIsWaitingForContent = true;
+		}
+
+		FCanvasTileItem TileItem( PagePosition, PageTexture->Resource, PageSize, Color );
+		TileItem.BlendMode = BlendMode;
+
+		// Virtual textures can't be drawn on a canvas, so their pages are drawn from tiles
+		const bool bIsVirtualTexture = Texture2D != nullptr && FPDFPageTileTree::IsVirtualTexture(Texture2D);
+		if (!bIsVirtualTexture && !bIsThumbnailDrawn)
+		{
+			Canvas->DrawItem( TileItem );
+		}
+
+		// Draw sharper tiles over the page when it is zoomed beyond the resolution of its texture
+		UPDF* PDF = PDFViewerPtr.Pin()->GetPDF();
+		if ((Settings.TiledRenderingEnabled || bIsVirtualTexture) && PDF != nullptr && !PDF->Filename.IsEmpty())
+		{
+			TSharedPtr<FPDFPageTileTree>& Tiles = PageTiles.FindOrAdd(PageIndex);
+			if (!Tiles.IsValid() || Tiles->GetPDF() != PDF || Tiles->GetTileSize() != Settings.TileSize)
+			{
+				Tiles = MakeShared<FPDFPageTileTree>(PDF, PageIndex);
+			}
+
+			Tiles->Draw(Canvas, Texture2D, PagePosition, PageSize, ViewportSize, Color, TileItem.BlendMode);
+			bIsWaitingForContent |= Tiles->IsRendering();
+		}
+		else
+		{
+			PageTiles.Remove(PageIndex);
+		}
+	}
+
+	// Draw a white border around the texture to show its extents, pages that are still being rendered only get their thumbnail and the border
+	if (Settings.TextureBorderEnabled)
+	{
+		FCanvasBoxItem BoxItem( PagePosition, PageSize );
+		BoxItem.SetColor( Settings.TextureBorderColor );
+		Canvas->DrawItem( BoxItem );
+	}
+}
+
+
+bool FPDFViewerViewportClient::DrawPageThumbnail(FCanvas* Canvas, int32 PageIndex, UTexture2D* PageTexture, const FVector2D& PagePosition, const FVector2D& PageSize, const FLinearColor& Color, ESimpleElementBlendMode BlendMode)
+{
+	UPDF* PDF = PDFViewerPtr.Pin()->GetPDF();
+	UTexture2D* Atlas = nullptr;
+	FVector2D UVOffset, UVSize;
+
+	if (PDF == nullptr || !PDF->GetPageThumbnail(PageIndex + 1, Atlas, UVOffset, UVSize) || Atlas->Resource == nullptr)
+	{
+		return false;
+	}
+
+	// The page texture is drawn as soon as its resident mips are at least as sharp as the thumbnail,
+	// virtual textures are covered by tiles once they arrive
+	if (PageTexture != nullptr && PageTexture->Resource != nullptr && !FPDFPageTileTree::IsVirtualTexture(PageTexture))
+	{
+		const int32 MipBias = PageTexture->GetNumMips() - PageTexture->GetNumResidentMips();
+		const int32 ResidentWidth = PageTexture->GetSurfaceWidth() >> FMath::Max(MipBias, 0);
+		if (ResidentWidth >= UVSize.X * Atlas->GetSurfaceWidth())
+		{
+			return false;
+		}
+	}
+
+	FCanvasTileItem TileItem( PagePosition, Atlas->Resource, PageSize, UVOffset, UVOffset + UVSize, Color );
+	TileItem.BlendMode = BlendMode;
+	Canvas->DrawItem( TileItem );
+
+	return true;
+}
+
+
+void FPDFViewerViewportClient::DrawContinuousPages(FCanvas* Canvas, UPDF* PDF, const FVector2D& ContentPosition, const FVector2D& PageSize, const FVector2D& ViewportSize, float ScrollPosition, const FLinearColor& Color)
+{
+	const UPDFViewerSettings& Settings = *GetDefault<UPDFViewerSettings>();
+	const int32 NumPages = PDF->GetPageCount();
+	const float PageStride = PageSize.Y + Settings.PageSpacing;
+
+	if (PageStride <= 0.0f)
+	{
+		return;
+	}
+
+	// All pages are laid out at the size of the displayed page, so the pages that intersect the viewport
+	// follow from the scroll position without visiting the others
+	const int32 FirstVisibleIndex = FMath::Clamp(FMath::FloorToInt(-ContentPosition.Y / PageStride), 0, NumPages - 1);
+	const int32 LastVisibleIndex = FMath::Clamp(FMath::FloorToInt((ViewportSize.Y - ContentPosition.Y) / PageStride), FirstVisibleIndex, NumPages - 1);
+
+	// Follow the page under the top of the viewport while the user scrolls, the gap above a page counts as part of it
+	if (ScrollPosition != LastScrollPosition)
+	{
+		ScrollDirection = (ScrollPosition > LastScrollPosition) ? 1 : -1;
+		LastScrollPosition = ScrollPosition;
+
+		const int32 TopPageIndex = FMath::Clamp(FMath::FloorToInt((Settings.PageSpacing + 1 - ContentPosition.Y) / PageStride), 0, NumPages - 1);
+		PDFViewerPtr.Pin()->SetCurrentPage(TopPageIndex + 1);
+	}
+
+	UpdatePinnedPages(PDF, FirstVisibleIndex, LastVisibleIndex);
+
+	// Visible pages that are not rendered yet are drawn from their thumbnails until they arrive
+	PDF->PrefetchPages(FirstVisibleIndex + 1, LastVisibleIndex + 1);
+
+	for (int32 PageIndex = FirstVisibleIndex; PageIndex <= LastVisibleIndex; PageIndex++)
+	{
+		UTexture2D* PageTexture = PDF->FindPageTexture(PageIndex + 1);
+		if (PageTexture == nullptr && PDF->IsPagePrefetching(PageIndex + 1))
+		{
+			bIsWaitingForContent = true;
+		}
+
+		FVector2D PagePosition(ContentPosition.X, ContentPosition.Y + PageIndex * PageStride);
+		FVector2D DrawSize = PageSize;
+
+		if (PageTexture != nullptr)
+		{
+			// Request the missing mips without waiting for them, the page sharpens once they are streamed in
+			PageTexture->SetForceMipLevelsToBeResident(30.0f);
+
+			// Pages of a different shape than the displayed page are fit into their place
+			const float TextureWidth = PageTexture->GetSurfaceWidth();
+			const float TextureHeight = PageTexture->GetSurfaceHeight();
+			if (TextureWidth > 0.0f && TextureHeight > 0.0f)
+			{
+				const float Scale = FMath::Min(PageSize.X / TextureWidth, PageSize.Y / TextureHeight);
+				DrawSize = FVector2D(TextureWidth * Scale, TextureHeight * Scale);
+				PagePosition.X += (PageSize.X - DrawSize.X) * 0.5f;
+			}
+		}
+
+		DrawPage(Canvas, PageIndex, PageTexture, PagePosition, DrawSize, ViewportSize, Color);
+	}
+
+	ReleasePageTiles(FirstVisibleIndex, LastVisibleIndex);
+
+	// Request the next pages in the scroll direction so that they are ready when they scroll into view
+	const int32 NumPrefetchPages = Settings.ScrollPrefetchPages;
+	const int32 FirstPrefetchIndex = (ScrollDirection > 0) ? LastVisibleIndex + 1 : FMath::Max(FirstVisibleIndex - NumPrefetchPages, 0);
+	const int32 LastPrefetchIndex = (ScrollDirection > 0) ? FMath::Min(LastVisibleIndex + NumPrefetchPages, NumPages - 1) : FirstVisibleIndex - 1;
+
+	if (NumPrefetchPages > 0 && FirstPrefetchIndex <= LastPrefetchIndex)
+	{
+		PDF->PrefetchPages(FirstPrefetchIndex + 1, LastPrefetchIndex + 1);
+
+		if (!PDF->bRenderPagesOnDemand)
+		{
+			for (int32 PageIndex = FirstPrefetchIndex; PageIndex <= LastPrefetchIndex; PageIndex++)
+			{
+				if (UTexture2D* PageTexture = PDF->FindPageTexture(PageIndex + 1))
+				{
+					PageTexture->SetForceMipLevelsToBeResident(30.0f);
+				}
+			}
+		}
+	}
+}
+
+
+void FPDFViewerViewportClient::CalculateContentDimensions(uint32& Width, uint32& Height) const
+{
+	PDFViewerPtr.Pin()->CalculateTextureDimensions(Width, Height);
+
+	const UPDFViewerSettings& Settings = *GetDefault<UPDFViewerSettings>();
+	UPDF* PDF = PDFViewerPtr.Pin()->GetPDF();
+
+	if (Settings.ContinuousScrollEnabled && PDF != nullptr && PDF->GetPageCount() > 1)
+	{
+		const uint32 NumPages = PDF->GetPageCount();
+		Height = Height * NumPages + Settings.PageSpacing * (NumPages - 1);
+	}
+}
+
+
+void FPDFViewerViewportClient::ScrollVertically(float Delta)
+{
+	TSharedPtr<SPDFViewerViewport> Viewport = PDFViewerViewportPtr.Pin();
+
+	if (!Viewport.IsValid() || !Viewport->GetVerticalScrollBar().IsValid())
+	{
+		return;
+	}
+
+	uint32 Width, Height;
+	CalculateContentDimensions(Width, Height);
+	float Ratio = GetViewportVerticalScrollBarRatio();
+
+	if (Ratio >= 1.0f || Height == 0)
+	{
+		return;
+	}
+
+	float Offset = 1.0f - Ratio - Viewport->GetVerticalScrollBar()->DistanceFromBottom();
+	Viewport->GetVerticalScrollBar()->SetState(FMath::Clamp(Offset + Delta / Height, 0.0f, 1.0f - Ratio), Ratio);
+	Viewport->RequestRedraw();
+}
+
+
+void FPDFViewerViewportClient::UpdatePinnedPages(UPDF* PDF, int32 FirstPageIndex, int32 LastPageIndex)
+{
+	for (auto It = PinnedPages.CreateIterator(); It; ++It)
+	{
+		if (PDF != PinnedPDF.Get() || *It < FirstPageIndex + 1 || *It > LastPageIndex + 1)
+		{
+			if (UPDF* PreviousPDF = PinnedPDF.Get())
+			{
+				PreviousPDF->UnpinPage(*It);
+			}
+			It.RemoveCurrent();
+		}
+	}
+
+	PinnedPDF = PDF;
+	for (int32 PageIndex = FirstPageIndex; PageIndex <= LastPageIndex; PageIndex++)
+	{
+		if (!PinnedPages.Contains(PageIndex + 1))
+		{
+			PDF->PinPage(PageIndex + 1);
+			PinnedPages.Add(PageIndex + 1);
+		}
+	}
+}
+
+
+void FPDFViewerViewportClient::ReleasePageTiles(int32 FirstPageIndex, int32 LastPageIndex)
+{
+	for (auto It = PageTiles.CreateIterator(); It; ++It)
+	{
+		if (It.Key() < FirstPageIndex || It.Key() > LastPageIndex)
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
+
 void FPDFViewerViewportClient::DestroyCheckerboardTexture()
 {
 	if (CheckerboardTexture)
@@ -6,10 +6,14 @@
 #include "InputCoreTypes.h"
 #include "UObject/GCObject.h"
 #include "UnrealClient.h"
+#include "BatchedElements.h"
 
 class FCanvas;
+class FPDFPageTileTree;
 class IPDFViewerToolkit;
 class SPDFViewerViewport;
+class UPDF;
+class UTexture;
 class UTexture2D;
 
 class FPDFViewerViewportClient
@@ -41,7 +45,45 @@ public:
 	float GetViewportVerticalScrollBarRatio() const;
 	float GetViewportHorizontalScrollBarRatio() const;
 
+	/** Scrolls to the top of a page in the continuous scroll mode */
+	void ScrollToPage(int32 Page);
+
+	/** Returns whether the last draw showed pages that are still being rendered or streamed in, so that the viewport must be drawn again */
+	bool IsWaitingForContent() const { return bIsWaitingForContent; }
+
 private:
+	/** Draws a page with its background, tiles and border */
+	void DrawPage(FCanvas* Canvas, int32 PageIndex, UTexture* PageTexture, const FVector2D& PagePosition, const FVector2D& PageSize, const FVector2D& ViewportSize, const FLinearColor& Color);
+
+	/**
+	 * Draws the thumbnail of a page while its texture is missing or its resident mips are less sharp than the thumbnail.
+	 *
+	 * @return Whether the thumbnail was drawn in place of the page texture.
+	 */
+	bool DrawPageThumbnail(FCanvas* Canvas, int32 PageIndex, UTexture2D* PageTexture, const FVector2D& PagePosition, const FVector2D& PageSize, const FLinearColor& Color, ESimpleElementBlendMode BlendMode);
+
+	/**
+	 * Draws the pages that intersect the viewport in the continuous scroll mode
+	 * and requests the next pages in the scroll direction.
+	 *
+	 * @param ContentPosition The position of the top left corner of the first page in the viewport.
+	 * @param PageSize The displayed size of a page, shared by all pages.
+	 * @param ScrollPosition The vertical position of the scrollbar in pixels.
+	 */
+	void DrawContinuousPages(FCanvas* Canvas, UPDF* PDF, const FVector2D& ContentPosition, const FVector2D& PageSize, const FVector2D& ViewportSize, float ScrollPosition, const FLinearColor& Color);
+
+	/** Returns the size of everything that can be scrolled, the displayed page or all pages in the continuous scroll mode */
+	void CalculateContentDimensions(uint32& Width, uint32& Height) const;
+
+	/** Moves the vertical scrollbar by a number of pixels */
+	void ScrollVertically(float Delta);
+
+	/** Pins the pages of a range and unpins the others, so that the page cache keeps the visible pages */
+	void UpdatePinnedPages(UPDF* PDF, int32 FirstPageIndex, int32 LastPageIndex);
+
+	/** Releases the tiles of the pages outside a range */
+	void ReleasePageTiles(int32 FirstPageIndex, int32 LastPageIndex);
+
 	/** Updates the states of the scrollbars */
 	void UpdateScrollBars();
 
@@ -60,4 +102,23 @@ private:
 
 	/** Checkerboard texture */
 	UTexture2D* CheckerboardTexture;
+
+	/** Tiles of the displayed pages rendered at the resolution of the current zoom, keyed by page index */
+	TMap<int32, TSharedPtr<FPDFPageTileTree>> PageTiles;
+
+	/** The PDF asset whose pages are pinned */
+	TWeakObjectPtr<UPDF> PinnedPDF;
+
+	/** The numbers of the pinned pages */
+	TSet<int32> PinnedPages;
+
+	/** The vertical scroll position of the last draw in pixels */
+	float LastScrollPosition;
+
+	/** 1 while scrolling down and -1 while scrolling up */
+	int32 ScrollDirection;
+
+	/** Whether the last draw showed pages that are still being rendered or streamed in */
+	bool bIsWaitingForContent;
+
 };
@@ -14,4 +14,11 @@ UPDFViewerSettings::UPDFViewerSettings( const FObjectInitializer& ObjectInitiali
 	, FitToViewport(true)
 	, TextureBorderColor(FColor::White)
 	, TextureBorderEnabled(true)
+	, TiledRenderingEnabled(true)
+	, TileSize(512)
+	, ContinuousScrollEnabled(false)
+	, PageSpacing(16)
+	, ScrollPrefetchPages(2)
+	, NavigationPrefetchPages(2)
+	, PrefetchLookaheadSeconds(1.0f)
 { }
@@ -31,6 +31,7 @@
 #include "PDFViewerConstants.h"
 #include "Models/PDFViewerCommands.h"
 #include "Widgets/SPDFViewerViewport.h"
+#include "Widgets/SPDFViewerPageList.h"
 #include "ISettingsModule.h"
 #include "Widgets/Docking/SDockTab.h"
 #include "Widgets/Input/SNumericEntryBox.h"
@@ -51,6 +52,7 @@ DEFINE_LOG_CATEGORY_STATIC(LogPDFViewer, Log, All);
 
 const FName FPDFViewerToolkit::ViewportTabId(TEXT("PDFViewer_Viewport"));
 const FName FPDFViewerToolkit::PropertiesTabId(TEXT("PDFViewer_Properties"));
+const FName FPDFViewerToolkit::PagesTabId(TEXT("PDFViewer_Pages"));
 
 UNREALED_API void GetBestFitForNumberOfTiles(int32 InSize, int32& OutRatioX, int32& OutRatioY);
 
@@ -98,6 +100,11 @@ void FPDFViewerToolkit::RegisterTabSpawners( const TSharedRef<class FTabManager>
 		.SetDisplayName(LOCTEXT("PropertiesTab", "Details") )
 		.SetGroup(WorkspaceMenuCategoryRef)
 		.SetIcon(FSlateIcon(FEditorStyle::GetStyleSetName(), "LevelEditor.Tabs.Details"));
+
+	InTabManager->RegisterTabSpawner(PagesTabId, FOnSpawnTab::CreateSP(this, &FPDFViewerToolkit::HandleTabSpawnerSpawnPages))
+		.SetDisplayName(LOCTEXT("PagesTab", "Pages"))
+		.SetGroup(WorkspaceMenuCategoryRef)
+		.SetIcon(FSlateIcon(FEditorStyle::GetStyleSetName(), "LevelEditor.Tabs.ContentBrowser"));
 }
 
 
@@ -107,6 +114,7 @@ void FPDFViewerToolkit::UnregisterTabSpawners( const TSharedRef<class FTabManage
 
 	InTabManager->UnregisterTabSpawner(ViewportTabId);
 	InTabManager->UnregisterTabSpawner(PropertiesTabId);
+	InTabManager->UnregisterTabSpawner(PagesTabId);
 }
 
 
@@ -115,6 +123,7 @@ void FPDFViewerToolkit::InitPDFViewer( const EToolkitMode::Type Mode, const TSha
 	PDF = CastChecked<UPDF>(ObjectToEdit);
 	CurrentPage = 1;
 	Texture = PDF->GetPageTexture(CurrentPage);
+	Prefetcher.PrefetchAhead(PDF, CurrentPage);
 
 	// Support undo/redo
 	Texture->SetFlags(RF_Transactional);
@@ -145,6 +154,10 @@ void FPDFViewerToolkit::InitPDFViewer( const EToolkitMode::Type Mode, const TSha
 	SpecifiedMipLevel = 0;
 	bUseSpecifiedMipLevel = false;
 
+	QuickInfoNumResidentMips = INDEX_NONE;
+	QuickInfoLODBias = INDEX_NONE;
+	QuickInfoMipLevel = INDEX_NONE;
+
 	SavedCompressionSetting = false;
 
 	Zoom = 1.0f;
@@ -154,17 +167,24 @@ void FPDFViewerToolkit::InitPDFViewer( const EToolkitMode::Type Mode, const TSha
 
 	BindCommands();
 	CreateInternalWidgets();
+	UpdatePrefetchText();
 
-	const TSharedRef<FTabManager::FLayout> StandaloneDefaultLayout = FTabManager::NewLayout("Standalone_PDFViewer_Layout_v3")
+	const TSharedRef<FTabManager::FLayout> StandaloneDefaultLayout = FTabManager::NewLayout("Standalone_PDFViewer_Layout_v4")
 		->AddArea
 		(
 			FTabManager::NewPrimaryArea()
 				->SetOrientation(Orient_Horizontal)
 				->Split
+				(
+					FTabManager::NewStack()
+						->AddTab(PagesTabId, ETabState::OpenedTab)
+						->SetSizeCoefficient(0.15f)
+				)
+				->Split
 				(
 					FTabManager::NewSplitter()
 						->SetOrientation(Orient_Vertical)
-						->SetSizeCoefficient(0.66f)
+						->SetSizeCoefficient(0.6f)
 						->Split
 						(
 							FTabManager::NewStack()
@@ -185,7 +205,7 @@ void FPDFViewerToolkit::InitPDFViewer( const EToolkitMode::Type Mode, const TSha
 				(
 					FTabManager::NewStack()
 						->AddTab(PropertiesTabId, ETabState::OpenedTab)
-						->SetSizeCoefficient(0.33f)
+						->SetSizeCoefficient(0.25f)
 				)
 		);
 
@@ -350,6 +370,63 @@ UTexture* FPDFViewerToolkit::GetTexture( ) const
 }
 
 
+UPDF* FPDFViewerToolkit::GetPDF( ) const
+{
+	return PDF;
+}
+
+
+int32 FPDFViewerToolkit::GetCurrentPage( ) const
+{
+	return CurrentPage;
+}
+
+
+void FPDFViewerToolkit::SetCurrentPage( int32 Page )
+{
+	// Texture keeps the page it was loaded for, so that scrolling doesn't render pages synchronously
+	const int32 PreviousPage = CurrentPage;
+	CurrentPage = FMath::Clamp(Page, 1, PDF->GetPageCount());
+
+	// The viewport prefetches the pages ahead of the scroll itself, so only the navigation is recorded here
+	if (CurrentPage != PreviousPage)
+	{
+		Prefetcher.RecordPageChange(PDF, PreviousPage, CurrentPage);
+		UpdatePrefetchText();
+	}
+
+	if (PageList.IsValid())
+	{
+		PageList->SelectPage(CurrentPage);
+	}
+}
+
+
+void FPDFViewerToolkit::GoToPage( int32 Page )
+{
+	if (Page < 1 || Page > PDF->GetPageCount())
+	{
+		return;
+	}
+
+	Prefetcher.RecordPageChange(PDF, CurrentPage, Page);
+
+	// Load the page before prefetching, so that it is rendered ahead of the pages after it
+	CurrentPage = Page;
+	LoadCurrentPageTexture();
+	Prefetcher.PrefetchAhead(PDF, CurrentPage);
+	UpdatePrefetchText();
+
+	TextureViewport->ScrollToPage(CurrentPage);
+	TextureViewport->RequestRedraw();
+
+	if (PageList.IsValid())
+	{
+		PageList->SelectPage(CurrentPage);
+	}
+}
+
+
 bool FPDFViewerToolkit::HasValidTextureResource( ) const
 {
 	return Texture != nullptr && Texture->Resource != nullptr;
@@ -377,6 +454,18 @@ void FPDFViewerToolkit::PopulateQuickInfo( )
 	UTexture2DDynamic* Texture2DDynamic = Cast<UTexture2DDynamic>(Texture);
 	UVolumeTexture* VolumeTexture = Cast<UVolumeTexture>(Texture);
 
+	// Nothing shown in the quick info changed since it was last populated
+	const int32 NumResidentMips = Texture2D ? Texture2D->GetNumResidentMips() : 0;
+	if (Texture == QuickInfoTexture.Get() && NumResidentMips == QuickInfoNumResidentMips && Texture->GetCachedLODBias() == QuickInfoLODBias && GetMipLevel() == QuickInfoMipLevel)
+	{
+		return;
+	}
+
+	QuickInfoTexture = Texture;
+	QuickInfoNumResidentMips = NumResidentMips;
+	QuickInfoLODBias = Texture->GetCachedLODBias();
+	QuickInfoMipLevel = GetMipLevel();
+
 	const uint32 SurfaceWidth = (uint32)Texture->GetSurfaceWidth();
 	const uint32 SurfaceHeight = (uint32)Texture->GetSurfaceHeight();
 	const uint32 SurfaceDepth =  VolumeTexture ? (uint32)VolumeTexture->GetSizeZ() : 1;
@@ -385,7 +474,7 @@ void FPDFViewerToolkit::PopulateQuickInfo( )
 	const uint32 ImportedHeight =  FMath::Max<uint32>(SurfaceHeight, Texture->Source.GetSizeY());
 	const uint32 ImportedDepth =  FMath::Max<uint32>(SurfaceDepth, VolumeTexture ? Texture->Source.GetNumSlices() : 1);
 
-	const int32 ActualMipBias = Texture2D ? (Texture2D->GetNumMips() - Texture2D->GetNumResidentMips()) : Texture->GetCachedLODBias();
+	const int32 ActualMipBias = Texture2D ? (Texture2D->GetNumMips() - NumResidentMips) : Texture->GetCachedLODBias();
 	const uint32 ActualWidth = FMath::Max<uint32>(SurfaceWidth >> ActualMipBias, 1);
 	const uint32 ActualHeight = FMath::Max<uint32>(SurfaceHeight >> ActualMipBias, 1);
 	const uint32 ActualDepth =  FMath::Max<uint32>(SurfaceDepth >> ActualMipBias, 1);
@@ -528,6 +617,7 @@ void FPDFViewerToolkit::SetZoom( double ZoomValue )
 {
 	Zoom = FMath::Clamp(ZoomValue, MinZoom, MaxZoom);
 	SetFitToViewport(false);
+	TextureViewport->RequestRedraw();
 }
 
 
@@ -604,6 +694,9 @@ void FPDFViewerToolkit::AddReferencedObjects( FReferenceCollector& Collector )
 
 void FPDFViewerToolkit::PostUndo( bool bSuccess )
 {
+	// The texture may have been restored to other settings
+	QuickInfoTexture = nullptr;
+	TextureViewport->RequestRedraw();
 }
 
 
@@ -694,6 +787,12 @@ void FPDFViewerToolkit::BindCommands( )
 		FCanExecuteAction(),
 		FIsActionChecked::CreateSP(this, &FPDFViewerToolkit::HandleTextureBorderActionIsChecked));
 
+	ToolkitCommands->MapAction(
+		Commands.ContinuousScroll,
+		FExecuteAction::CreateSP(this, &FPDFViewerToolkit::HandleContinuousScrollActionExecute),
+		FCanExecuteAction(),
+		FIsActionChecked::CreateSP(this, &FPDFViewerToolkit::HandleContinuousScrollActionIsChecked));
+
 	ToolkitCommands->MapAction(
 		Commands.BackPage,
 		FExecuteAction::CreateSP(this, &FPDFViewerToolkit::HandleBackPage),
@@ -725,6 +824,7 @@ TSharedRef<SWidget> FPDFViewerToolkit::BuildTexturePropertiesWidget( )
 void FPDFViewerToolkit::CreateInternalWidgets( )
 {
 	TextureViewport = SNew(SPDFViewerViewport, SharedThis(this));
+	PageList = SNew(SPDFViewerPageList, SharedThis(this));
 
 	TextureProperties = SNew(SVerticalBox)
 
@@ -818,6 +918,14 @@ void FPDFViewerToolkit::CreateInternalWidgets( )
 				[
 					SAssignNew(NumMipsText, STextBlock)
 				]
+
+				+ SVerticalBox::Slot()
+				.AutoHeight()
+				.VAlign(VAlign_Center)
+				.Padding(4.0f)
+				[
+					SAssignNew(PrefetchText, STextBlock)
+				]
 			]
 		]
 	]
@@ -929,6 +1037,35 @@ bool FPDFViewerToolkit::IsCubeTexture( ) const
 }
 
 
+void FPDFViewerToolkit::LoadCurrentPageTexture( )
+{
+	// Rendering or loading a page takes too long for a page turn, so the page is requested in the background. Texture
+	// keeps the previous page until it arrives, and the viewport draws the thumbnail of the current page meanwhile.
+	if (PDF->LoadsPagesInBackground() && PDF->FindPageTexture(CurrentPage) == nullptr)
+	{
+		PDF->PrefetchPages(CurrentPage, CurrentPage);
+		return;
+	}
+
+	Texture = PDF->GetPageTexture(CurrentPage);
+}
+
+
+void FPDFViewerToolkit::UpdatePrefetchText( )
+{
+	if (!PrefetchText.IsValid())
+	{
+		return;
+	}
+
+	const int32 NumHits = Prefetcher.GetNumHits();
+	const int32 NumPageChanges = NumHits + Prefetcher.GetNumMisses();
+	const float HitRate = (NumPageChanges > 0) ? (float)NumHits / NumPageChanges : 0.0f;
+
+	PrefetchText->SetText(FText::Format(NSLOCTEXT("PDFViewer", "QuickInfo_Prefetch", "Prefetch Hits: {0} / {1} ({2})"), FText::AsNumber(NumHits), FText::AsNumber(NumPageChanges), FText::AsPercent(HitRate)));
+}
+
+
 /* FPDFViewerToolkit callbacks
  *****************************************************************************/
 
@@ -948,6 +1085,7 @@ bool FPDFViewerToolkit::HandleAlphaChannelActionCanExecute( ) const
 void FPDFViewerToolkit::HandleAlphaChannelActionExecute( )
 {
 	bIsAlphaChannel = !bIsAlphaChannel;
+	TextureViewport->RequestRedraw();
 }
 
 
@@ -960,6 +1098,7 @@ bool FPDFViewerToolkit::HandleAlphaChannelActionIsChecked( ) const
 void FPDFViewerToolkit::HandleBlueChannelActionExecute( )
 {
 	 bIsBlueChannel = !bIsBlueChannel;
+	TextureViewport->RequestRedraw();
 }
 
 
@@ -1016,6 +1155,7 @@ bool FPDFViewerToolkit::HandleFitToViewportActionIsChecked( ) const
 void FPDFViewerToolkit::HandleGreenChannelActionExecute( )
 {
 	 bIsGreenChannel = !bIsGreenChannel;
+	TextureViewport->RequestRedraw();
 }
 
 
@@ -1028,6 +1168,7 @@ bool FPDFViewerToolkit::HandleGreenChannelActionIsChecked( ) const
 void FPDFViewerToolkit::HandleRedChannelActionExecute( )
 {
 	bIsRedChannel = !bIsRedChannel;
+	TextureViewport->RequestRedraw();
 }
 
 
@@ -1040,6 +1181,7 @@ bool FPDFViewerToolkit::HandleRedChannelActionIsChecked( ) const
 void FPDFViewerToolkit::HandleDesaturationChannelActionExecute( )
 {
 	bIsDesaturation = !bIsDesaturation;
+	TextureViewport->RequestRedraw();
 }
 
 
@@ -1072,6 +1214,18 @@ TSharedRef<SDockTab> FPDFViewerToolkit::HandleTabSpawnerSpawnProperties( const F
 }
 
 
+TSharedRef<SDockTab> FPDFViewerToolkit::HandleTabSpawnerSpawnPages( const FSpawnTabArgs& Args )
+{
+	check(Args.GetTabId() == PagesTabId);
+
+	return SNew(SDockTab)
+		.Label(LOCTEXT("PagesTitle", "Pages"))
+		[
+			PageList.ToSharedRef()
+		];
+}
+
+
 TSharedRef<SDockTab> FPDFViewerToolkit::HandleTabSpawnerSpawnViewport( const FSpawnTabArgs& Args )
 {
 	check(Args.GetTabId() == ViewportTabId);
@@ -1100,13 +1254,30 @@ bool FPDFViewerToolkit::HandleTextureBorderActionIsChecked( ) const
 }
 
 
+void FPDFViewerToolkit::HandleContinuousScrollActionExecute( )
+{
+	UPDFViewerSettings& Settings = *GetMutableDefault<UPDFViewerSettings>();
+	Settings.ContinuousScrollEnabled = !Settings.ContinuousScrollEnabled;
+	Settings.PostEditChange();
+
+	// The current page may have changed while scrolling without loading its texture
+	LoadCurrentPageTexture();
+	TextureViewport->ScrollToPage(CurrentPage);
+	TextureViewport->RequestRedraw();
+}
+
+
+bool FPDFViewerToolkit::HandleContinuousScrollActionIsChecked( ) const
+{
+	const UPDFViewerSettings& Settings = *GetDefault<UPDFViewerSettings>();
+
+	return Settings.ContinuousScrollEnabled;
+}
+
+
 void FPDFViewerToolkit::HandleCurrentPageEntryBoxChanged(int32 NewPageCount)
 {
-	if (NewPageCount >= 1 && NewPageCount <= PDF->GetPageCount())
-	{
-		CurrentPage = NewPageCount;
-		Texture = PDF->GetPageTexture(CurrentPage);
-	}
+	GoToPage(NewPageCount);
 }
 
 
@@ -1118,15 +1289,13 @@ TOptional<int32> FPDFViewerToolkit::HandleCurrentPageEntryBoxValue() const
 
 void FPDFViewerToolkit::HandleBackPage()
 {
-	CurrentPage--;
-	Texture = PDF->GetPageTexture(CurrentPage);
+	GoToPage(CurrentPage - 1);
 }
 
 
 void FPDFViewerToolkit::HandleNextPage()
 {
-	CurrentPage++;
-	Texture = PDF->GetPageTexture(CurrentPage);
+	GoToPage(CurrentPage + 1);
 }
 
 
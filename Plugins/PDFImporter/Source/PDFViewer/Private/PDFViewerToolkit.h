@@ -11,9 +11,11 @@
 #include "Interfaces/IPDFViewerToolkit.h"
 #include "IDetailsView.h"
 #include "PDFViewerSettings.h"
+#include "Models/PDFPagePrefetcher.h"
 
 class SDockableTab;
 class STextBlock;
+class SPDFViewerPageList;
 class SPDFViewerViewport;
 class UFactory;
 class UTexture;
@@ -62,6 +64,10 @@ public:
 	virtual bool GetFitToViewport( ) const override;
 	virtual int32 GetMipLevel( ) const override;
 	virtual UTexture* GetTexture( ) const override;
+	virtual UPDF* GetPDF( ) const override;
+	virtual int32 GetCurrentPage( ) const override;
+	virtual void SetCurrentPage( int32 Page ) override;
+	virtual void GoToPage( int32 Page ) override;
 	virtual bool HasValidTextureResource( ) const override;
 	virtual bool GetUseSpecifiedMip( ) const override;
 	virtual double GetZoom( ) const override;
@@ -134,6 +140,16 @@ protected:
 	 */
 	bool IsCubeTexture( ) const;
 
+	/**
+	 * Loads the texture of the current page without waiting for pages rendered on demand.
+	 */
+	void LoadCurrentPageTexture( );
+
+	/**
+	 * Shows the hit and miss counts of the page prefetcher in the quick info.
+	 */
+	void UpdatePrefetchText( );
+
 private:
 
 	// Callback for toggling the Alpha channel action.
@@ -193,6 +209,9 @@ private:
 	// Callback for spawning the Properties tab.
 	TSharedRef<SDockTab> HandleTabSpawnerSpawnProperties( const FSpawnTabArgs& Args );
 
+	// Callback for spawning the Pages tab.
+	TSharedRef<SDockTab> HandleTabSpawnerSpawnPages( const FSpawnTabArgs& Args );
+
 	// Callback for spawning the Viewport tab.
 	TSharedRef<SDockTab> HandleTabSpawnerSpawnViewport( const FSpawnTabArgs& Args );
 
@@ -202,6 +221,12 @@ private:
 	// Callback for getting the checked state of the Texture Border action.
 	bool HandleTextureBorderActionIsChecked( ) const;
 
+	// Callback for toggling the Continuous Scroll action.
+	void HandleContinuousScrollActionExecute( );
+
+	// Callback for getting the checked state of the Continuous Scroll action.
+	bool HandleContinuousScrollActionIsChecked( ) const;
+
 	// Callback that updates the current page
 	void HandleCurrentPageEntryBoxChanged(int32 NewPageCount);
 
@@ -239,6 +264,9 @@ private:
 	/** Viewport */
 	TSharedPtr<SPDFViewerViewport> TextureViewport;
 
+	/** Page navigator */
+	TSharedPtr<SPDFViewerPageList> PageList;
+
 	/** Properties tab */
 	TSharedPtr<SVerticalBox> TextureProperties;
 
@@ -255,6 +283,10 @@ private:
 	TSharedPtr<STextBlock> LODBiasText;
 	TSharedPtr<STextBlock> HasAlphaChannelText;
 	TSharedPtr<STextBlock> NumMipsText;
+	TSharedPtr<STextBlock> PrefetchText;
+
+	/** Warms the pages ahead in the navigation direction */
+	FPDFPagePrefetcher Prefetcher;
 
 	/** If true, displays the red channel */
 	bool bIsRedChannel;
@@ -275,6 +307,12 @@ private:
 	uint32 PreviewEffectiveTextureWidth;
 	uint32 PreviewEffectiveTextureHeight;
 
+	/** The texture and streaming state the quick info was last populated for, so that it isn't formatted again on every draw */
+	TWeakObjectPtr<UTexture> QuickInfoTexture;
+	int32 QuickInfoNumResidentMips;
+	int32 QuickInfoLODBias;
+	int32 QuickInfoMipLevel;
+
 	/** Which mip level should be shown */
 	int32 SpecifiedMipLevel;
 	/* When true, the specified mip value is used. Top mip is used when false.*/
@@ -299,4 +337,7 @@ private:
 
 	// The name of the Properties tab.
 	static const FName PropertiesTabId;
+
+	// The name of the Pages tab.
+	static const FName PagesTabId;
 };
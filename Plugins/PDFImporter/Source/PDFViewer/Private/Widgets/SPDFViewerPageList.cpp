@@ -0,0 +1,144 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "Widgets/SPDFViewerPageList.h"
+#include "Widgets/Images/SImage.h"
+#include "Widgets/Layout/SBox.h"
+#include "Widgets/Layout/SScaleBox.h"
+#include "Widgets/Text/STextBlock.h"
+#include "Widgets/Views/STableRow.h"
+#include "Engine/Texture2D.h"
+#include "PDF.h"
+
+
+#define LOCTEXT_NAMESPACE "SPDFViewerPageList"
+
+// Specifies the height at which the thumbnails are displayed.
+const float ThumbnailHeight = 160.0f;
+
+
+/* SPDFViewerPageList interface
+ *****************************************************************************/
+
+void SPDFViewerPageList::Construct( const FArguments& InArgs, const TSharedRef<IPDFViewerToolkit>& InToolkit )
+{
+	ToolkitPtr = InToolkit;
+
+	UPDF* PDF = InToolkit->GetPDF();
+	const int32 NumPages = (PDF != nullptr) ? PDF->GetPageCount() : 0;
+	for (int32 Page = 1; Page <= NumPages; Page++)
+	{
+		Pages.Add(MakeShared<int32>(Page));
+	}
+
+	// The list only generates the rows in view, so it stays fast for any number of pages
+	ChildSlot
+	[
+		SAssignNew(PageListView, SListView<TSharedPtr<int32>>)
+			.ListItemsSource(&Pages)
+			.SelectionMode(ESelectionMode::Single)
+			.OnGenerateRow(this, &SPDFViewerPageList::HandleGenerateRow)
+			.OnSelectionChanged(this, &SPDFViewerPageList::HandleSelectionChanged)
+	];
+
+	SelectPage(InToolkit->GetCurrentPage());
+}
+
+
+void SPDFViewerPageList::SelectPage( int32 Page )
+{
+	if (!Pages.IsValidIndex(Page - 1) || !PageListView.IsValid())
+	{
+		return;
+	}
+
+	TSharedPtr<int32> Item = Pages[Page - 1];
+	if (!PageListView->IsItemSelected(Item))
+	{
+		PageListView->SetSelection(Item, ESelectInfo::Direct);
+		PageListView->RequestScrollIntoView(Item);
+	}
+}
+
+
+/* SPDFViewerPageList callbacks
+ *****************************************************************************/
+
+TSharedRef<ITableRow> SPDFViewerPageList::HandleGenerateRow( TSharedPtr<int32> Page, const TSharedRef<STableViewBase>& OwnerTable )
+{
+	const FSlateBrush* ThumbnailBrush = GetThumbnailBrush(*Page);
+
+	TSharedRef<SVerticalBox> Content = SNew(SVerticalBox);
+
+	if (ThumbnailBrush != nullptr)
+	{
+		Content->AddSlot()
+			.AutoHeight()
+			.HAlign(HAlign_Center)
+			.Padding(4.0f)
+			[
+				SNew(SBox)
+					.HeightOverride(ThumbnailHeight)
+					[
+						SNew(SScaleBox)
+							.Stretch(EStretch::ScaleToFit)
+							[
+								SNew(SImage)
+									.Image(ThumbnailBrush)
+							]
+					]
+			];
+	}
+
+	Content->AddSlot()
+		.AutoHeight()
+		.HAlign(HAlign_Center)
+		.Padding(4.0f)
+		[
+			SNew(STextBlock)
+				.Text(FText::AsNumber(*Page))
+		];
+
+	return SNew(STableRow<TSharedPtr<int32>>, OwnerTable)
+		[
+			Content
+		];
+}
+
+
+void SPDFViewerPageList::HandleSelectionChanged( TSharedPtr<int32> Page, ESelectInfo::Type SelectInfo )
+{
+	// Pages selected by the viewer itself are already displayed
+	if (Page.IsValid() && SelectInfo != ESelectInfo::Direct && ToolkitPtr.IsValid())
+	{
+		ToolkitPtr.Pin()->GoToPage(*Page);
+	}
+}
+
+
+const FSlateBrush* SPDFViewerPageList::GetThumbnailBrush( int32 Page )
+{
+	if (const TSharedPtr<FSlateBrush>* ExistingBrush = ThumbnailBrushes.Find(Page))
+	{
+		return ExistingBrush->Get();
+	}
+
+	UPDF* PDF = ToolkitPtr.IsValid() ? ToolkitPtr.Pin()->GetPDF() : nullptr;
+	UTexture2D* Atlas;
+	FVector2D UVOffset, UVSize;
+	if (PDF == nullptr || !PDF->GetPageThumbnail(Page, Atlas, UVOffset, UVSize))
+	{
+		return nullptr;
+	}
+
+	// The brush draws the region of the page from the atlas at the size it was rendered at
+	TSharedPtr<FSlateBrush> Brush = MakeShared<FSlateBrush>();
+	Brush->SetResourceObject(Atlas);
+	Brush->ImageSize = FVector2D(Atlas->GetSurfaceWidth() * UVSize.X, Atlas->GetSurfaceHeight() * UVSize.Y);
+	Brush->SetUVRegion(FBox2D(UVOffset, UVOffset + UVSize));
+	ThumbnailBrushes.Add(Page, Brush);
+
+	return Brush.Get();
+}
+
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,68 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Widgets/DeclarativeSyntaxSupport.h"
+#include "Widgets/SCompoundWidget.h"
+#include "Widgets/Views/SListView.h"
+#include "Interfaces/IPDFViewerToolkit.h"
+
+struct FSlateBrush;
+
+/**
+ * Implements the page navigator of the PDF viewer.
+ *
+ * Each page is shown with its thumbnail from the atlases of the PDF asset, so that
+ * navigating a long document never loads the full resolution pages.
+ */
+class SPDFViewerPageList
+	: public SCompoundWidget
+{
+public:
+
+	SLATE_BEGIN_ARGS(SPDFViewerPageList) { }
+	SLATE_END_ARGS()
+
+public:
+
+	/**
+	 * Constructs the widget.
+	 *
+	 * @param InArgs The construction arguments.
+	 * @param InToolkit The PDF viewer that owns this widget.
+	 */
+	void Construct( const FArguments& InArgs, const TSharedRef<IPDFViewerToolkit>& InToolkit );
+
+	/**
+	 * Selects a page in the list and scrolls it into view.
+	 *
+	 * @param Page The number of the page, starting at 1.
+	 */
+	void SelectPage( int32 Page );
+
+private:
+
+	// Callback for generating a row of the page list.
+	TSharedRef<ITableRow> HandleGenerateRow( TSharedPtr<int32> Page, const TSharedRef<STableViewBase>& OwnerTable );
+
+	// Callback for selecting a page in the list.
+	void HandleSelectionChanged( TSharedPtr<int32> Page, ESelectInfo::Type SelectInfo );
+
+	// Returns the brush that draws the thumbnail of a page, nullptr if the PDF has no thumbnails.
+	const FSlateBrush* GetThumbnailBrush( int32 Page );
+
+private:
+
+	// Pointer back to the PDF viewer that owns us.
+	TWeakPtr<IPDFViewerToolkit> ToolkitPtr;
+
+	// The numbers of all pages, the items of the list.
+	TArray<TSharedPtr<int32>> Pages;
+
+	// The list of pages.
+	TSharedPtr<SListView<TSharedPtr<int32>>> PageListView;
+
+	// Brushes of the thumbnails created so far, keyed by page number.
+	TMap<int32, TSharedPtr<FSlateBrush>> ThumbnailBrushes;
+};
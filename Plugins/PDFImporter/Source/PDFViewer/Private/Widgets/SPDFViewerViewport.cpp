@@ -11,8 +11,11 @@
 #include "Widgets/Input/SSlider.h"
 #include "Engine/Texture.h"
 #include "Engine/VolumeTexture.h"
+#include "UObject/UObjectGlobals.h"
 #include "Slate/SceneViewport.h"
 #include "PDFViewerConstants.h"
+#include "PDFViewerSettings.h"
+#include "PDF.h"
 #include "Widgets/SPDFViewerViewportToolbar.h"
 #include "Widgets/Input/SNumericEntryBox.h"
 
@@ -26,6 +29,15 @@ const int32 MaxExposure = 10;
 const int32 MinExposure = -10;
 
 
+/* SPDFViewerViewport structors
+ *****************************************************************************/
+
+SPDFViewerViewport::~SPDFViewerViewport( )
+{
+	FCoreUObjectDelegates::OnObjectPropertyChanged.RemoveAll(this);
+}
+
+
 /* SPDFViewerViewport interface
  *****************************************************************************/
 
@@ -39,6 +51,8 @@ void SPDFViewerViewport::Construct( const FArguments& InArgs, const TSharedRef<I
 {
 	ExposureBias = 0;
 	bIsRenderingEnabled = true;
+	bNeedsRedraw = true;
+	LastViewportSize = FVector2D::ZeroVector;
 	ToolkitPtr = InToolkit;
 	
 	// create zoom menu
@@ -284,6 +298,8 @@ void SPDFViewerViewport::Construct( const FArguments& InArgs, const TSharedRef<I
 
 	// The viewport widget needs an interface so it knows what should render
 	ViewportWidget->SetViewportInterface( Viewport.ToSharedRef() );
+
+	FCoreUObjectDelegates::OnObjectPropertyChanged.AddSP(this, &SPDFViewerViewport::HandleObjectPropertyChanged);
 }
 
 
@@ -298,6 +314,7 @@ void SPDFViewerViewport::ModifyCheckerboardTextureColors( )
 void SPDFViewerViewport::EnableRendering()
 {
 	bIsRenderingEnabled = true;
+	bNeedsRedraw = true;
 }
 
 void SPDFViewerViewport::DisableRendering()
@@ -305,6 +322,19 @@ void SPDFViewerViewport::DisableRendering()
 	bIsRenderingEnabled = false;
 }
 
+void SPDFViewerViewport::RequestRedraw()
+{
+	bNeedsRedraw = true;
+}
+
+void SPDFViewerViewport::ScrollToPage( int32 Page )
+{
+	if (ViewportClient.IsValid())
+	{
+		ViewportClient->ScrollToPage(Page);
+	}
+}
+
 TSharedPtr<FSceneViewport> SPDFViewerViewport::GetViewport( ) const
 {
 	return Viewport;
@@ -331,8 +361,17 @@ TSharedPtr<SScrollBar> SPDFViewerViewport::GetHorizontalScrollBar( ) const
 
 void SPDFViewerViewport::Tick( const FGeometry& AllottedGeometry, const double InCurrentTime, const float InDeltaTime )
 {
-	if (bIsRenderingEnabled)
+	if (!bIsRenderingEnabled)
+	{
+		return;
+	}
+
+	// Only draw when something changed or the last draw showed pages that were still being rendered or streamed in
+	const FVector2D ViewportSize = AllottedGeometry.GetLocalSize();
+	if (bNeedsRedraw || ViewportSize != LastViewportSize || ViewportClient->IsWaitingForContent())
 	{
+		bNeedsRedraw = false;
+		LastViewportSize = ViewportSize;
 		Viewport->Invalidate();
 	}
 }
@@ -372,6 +411,7 @@ TOptional<int32> SPDFViewerViewport::HandleExposureBiasBoxValue( ) const
 void SPDFViewerViewport::HandleExposureBiasBoxValueChanged( int32 NewExposure )
 {
 	ExposureBias = NewExposure;
+	RequestRedraw();
 }
 
 
@@ -382,6 +422,7 @@ void SPDFViewerViewport::HandleHorizontalScrollBarScrolled( float InScrollOffset
 	InScrollOffsetFraction = FMath::Clamp(InScrollOffsetFraction, 0.0f, MaxOffset);
 
 	TextureViewportHorizontalScrollBar->SetState(InScrollOffsetFraction, Ratio);
+	RequestRedraw();
 }
 
 
@@ -403,6 +444,7 @@ void SPDFViewerViewport::HandleVerticalScrollBarScrolled( float InScrollOffsetFr
 	InScrollOffsetFraction = FMath::Clamp(InScrollOffsetFraction, 0.0f, MaxOffset);
 
 	TextureViewportVerticalScrollBar->SetState(InScrollOffsetFraction, Ratio);
+	RequestRedraw();
 }
 
 
@@ -439,6 +481,16 @@ bool SPDFViewerViewport::HasValidTextureResource() const
 	return ToolkitPtr.Pin()->HasValidTextureResource();
 }
 
+void SPDFViewerViewport::HandleObjectPropertyChanged( UObject* Object, FPropertyChangedEvent& PropertyChangedEvent )
+{
+	TSharedPtr<IPDFViewerToolkit> Toolkit = ToolkitPtr.Pin();
+
+	if (Object == GetDefault<UPDFViewerSettings>() || (Toolkit.IsValid() && (Object == Toolkit->GetPDF() || Object == Toolkit->GetTexture())))
+	{
+		RequestRedraw();
+	}
+}
+
 FText SPDFViewerViewport::HandleZoomPercentageText( ) const
 {
 	const bool bFitToViewport = ToolkitPtr.Pin()->GetFitToViewport();
@@ -26,6 +26,11 @@ public:
 
 public:
 
+	/**
+	 * Destructor.
+	 */
+	~SPDFViewerViewport( );
+
 	/**
 	 */
 	void AddReferencedObjects( FReferenceCollector& Collector );
@@ -58,6 +63,16 @@ public:
 	/** Disable viewport rendering */
 	void DisableRendering();
 
+	/** Draws the viewport again on the next tick, the viewport is only drawn when something changed */
+	void RequestRedraw();
+
+	/**
+	 * Scrolls to the top of a page in the continuous scroll mode.
+	 *
+	 * @param Page The number of the page, starting at 1.
+	 */
+	void ScrollToPage( int32 Page );
+
 	TSharedPtr<FSceneViewport> GetViewport( ) const;
 	TSharedPtr<SViewport> GetViewportWidget( ) const;
 	TSharedPtr<SScrollBar> GetVerticalScrollBar( ) const;
@@ -128,6 +143,9 @@ private:
 	// Checks if the texture being edited has a valid texture resource
 	bool HasValidTextureResource( ) const;
 
+	// Callback for property changes of the viewer settings and the displayed asset.
+	void HandleObjectPropertyChanged( UObject* Object, struct FPropertyChangedEvent& PropertyChangedEvent );
+
 private:
 
 	// Which exposure level should be used, in FStop e.g. 0:original, -1:half as bright, 1:2x as bright, 2:4x as bright.
@@ -153,4 +171,10 @@ private:
 
 	// Is rendering currently enabled? (disabled when reimporting a texture)
 	bool bIsRenderingEnabled;
+
+	// Does the viewport need to be drawn again? Set when the zoom, scroll position, page or settings change.
+	bool bNeedsRedraw;
+
+	// The size of the viewport in the last tick, the viewport is drawn again when it is resized.
+	FVector2D LastViewportSize;
 };
@@ -6,6 +6,7 @@
 #include "SceneTypes.h"
 #include "Toolkits/AssetEditorToolkit.h"
 
+class UPDF;
 class UTexture;
 
 /**
@@ -18,6 +19,18 @@ public:
 	/** Returns the Texture asset being inspected by the Texture editor */
 	virtual UTexture* GetTexture() const = 0;
 
+	/** Returns the PDF asset being inspected */
+	virtual UPDF* GetPDF() const = 0;
+
+	/** Returns the number of the page being displayed, starting at 1 */
+	virtual int32 GetCurrentPage() const = 0;
+
+	/** Sets the number of the page being displayed without loading its texture, used while scrolling through the pages */
+	virtual void SetCurrentPage(int32 Page) = 0;
+
+	/** Displays a page, scrolling to it in the continuous scroll mode */
+	virtual void GoToPage(int32 Page) = 0;
+
 	/** Returns if the Texture asset being inspected has a valid texture resource */
 	virtual bool HasValidTextureResource() const = 0;
 